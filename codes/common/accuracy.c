@@ -0,0 +1,267 @@
+#include "accuracy.h"
+#include "glState.h"
+#include "glslGen.h"
+#include "platform.h"
+#include "shader.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RANGES 2
+
+struct AccuracyRange {
+    float xMin, xMax;
+};
+
+struct AccuracyBuiltin {
+    const char *name;
+    const char *expression;     // GLSL, in terms of x
+    double (*reference)(double);
+    struct AccuracyRange ranges[MAX_RANGES];
+    int rangeCount;
+};
+
+struct AccuracyStats {
+    double maxUlp, sumUlp;
+    double maxAbs, sumAbs;
+    long compared;
+    long nonFinite;             // GPU and libm disagree on finiteness
+};
+
+static double inverseSqrt(double x) { return 1.0 / sqrt(x); }
+static double powTwoAndHalf(double x) { return pow(x, 2.5); }
+
+#define PI_F 3.14159265f
+
+static const struct AccuracyBuiltin builtins[] = {
+    {"sin",         "sin(x)",         sin,   {{-PI_F, PI_F}, {-100.0f, 100.0f}}, 2},
+    {"cos",         "cos(x)",         cos,   {{-PI_F, PI_F}, {-100.0f, 100.0f}}, 2},
+    {"tan",         "tan(x)",         tan,   {{-1.5f, 1.5f}}, 1},
+    {"asin",        "asin(x)",        asin,  {{-1.0f, 1.0f}}, 1},
+    {"acos",        "acos(x)",        acos,  {{-1.0f, 1.0f}}, 1},
+    {"atan",        "atan(x)",        atan,  {{-10.0f, 10.0f}}, 1},
+    {"exp",         "exp(x)",         exp,   {{-10.0f, 10.0f}}, 1},
+    {"exp2",        "exp2(x)",        exp2,  {{-20.0f, 20.0f}}, 1},
+    {"log",         "log(x)",         log,   {{0.001f, 1.0f}, {1.0f, 1000.0f}}, 2},
+    {"log2",        "log2(x)",        log2,  {{0.001f, 1.0f}, {1.0f, 1000.0f}}, 2},
+    {"sqrt",        "sqrt(x)",        sqrt,  {{0.0f, 1.0f}, {1.0f, 10000.0f}}, 2},
+    {"inversesqrt", "inversesqrt(x)", inverseSqrt, {{0.001f, 1.0f}, {1.0f, 10000.0f}}, 2},
+    {"pow",         "pow(x, 2.5)",    powTwoAndHalf, {{0.01f, 10.0f}}, 1},
+};
+
+#define BUILTIN_COUNT (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+// GLSL ES 1.00 has no floatBitsToUint, so the float is split into sign,
+// exponent and mantissa arithmetically and written as the four bytes of its
+// IEEE-754 encoding, most significant first. Denormals flush to zero.
+static const char *fragmentTemplate =
+    "#version 100\n"
+    "precision highp float;\n"
+    "uniform vec2 uRange;\n"
+    "uniform float uSide;\n"
+    "uniform float uInvCount;\n"
+    "vec4 packFloat(float v) {\n"
+    "    float a = abs(v);\n"
+    "    if (v != v) return vec4(127.0, 192.0, 0.0, 0.0) / 255.0;\n"
+    "    float s = v < 0.0 ? 128.0 : 0.0;\n"
+    "    if (a < 1.17549435e-38) return vec4(s, 0.0, 0.0, 0.0) / 255.0;\n"
+    "    if (a > 3.40282347e38) return vec4(s + 127.0, 128.0, 0.0, 0.0) / 255.0;\n"
+    "    float e = floor(log2(a));\n"
+    "    float m = a * exp2(-e);\n"
+    "    if (m >= 2.0) { m *= 0.5; e += 1.0; }\n"
+    "    if (m < 1.0) { m *= 2.0; e -= 1.0; }\n"
+    "    e += 127.0;\n"
+    "    m = (m - 1.0) * 8388608.0;\n"
+    "    float b0 = s + floor(e / 2.0);\n"
+    "    float b1 = mod(e, 2.0) * 128.0 + floor(m / 65536.0);\n"
+    "    float b2 = mod(floor(m / 256.0), 256.0);\n"
+    "    float b3 = mod(m, 256.0);\n"
+    "    return vec4(b0, b1, b2, b3) / 255.0;\n"
+    "}\n"
+    "void main() {\n"
+    "    float index = floor(gl_FragCoord.y) * uSide + floor(gl_FragCoord.x);\n"
+    "    float x = uRange.x + (uRange.y - uRange.x) * (index * uInvCount);\n"
+    "    gl_FragColor = packFloat(%s);\n"
+    "}";
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec2 aPos;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "}";
+
+// Generated fragment shaders, one per builtin and the identity pass last. They
+// stay alive for the whole run because buildProgram() keeps pointers to them.
+static char *fragmentSources[BUILTIN_COUNT + 1];
+
+static GLuint buildBuiltinProgram(int index, const char *name, const char *expression) {
+    char label[64];
+    snprintf(label, sizeof(label), "accuracy.%s", name);
+    if (!fragmentSources[index]) {
+        fragmentSources[index] = formatSource(fragmentTemplate, expression);
+    }
+    return buildProgram(label, vertexSource, fragmentSources[index]);
+}
+
+static float unpackFloat(const unsigned char *bytes) {
+    uint32_t bits = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Draws the full-screen quad with program and unpacks every fragment into values.
+static void evaluate(GLuint program, GLuint quad, int side, struct AccuracyRange range,
+                     unsigned char *pixels, float *values) {
+    stateUseProgram(program);
+    glUniform2f(programUniform(program, "uRange"), range.xMin, range.xMax);
+    glUniform1f(programUniform(program, "uSide"), (float)side);
+    glUniform1f(programUniform(program, "uInvCount"), 1.0f / ((float)side * side));
+
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    stateVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glReadPixels(0, 0, side, side, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    for (long i = 0; i < (long)side * side; i++) {
+        values[i] = unpackFloat(pixels + i * 4);
+    }
+}
+
+static void compare(const struct AccuracyBuiltin *builtin, const float *inputs, const float *results,
+                    long count, struct AccuracyStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    for (long i = 0; i < count; i++) {
+        double expected = builtin->reference(inputs[i]);
+        float got = results[i];
+
+        if (!isfinite(expected) || !isfinite(got)) {
+            if (isfinite(expected) != isfinite(got)) stats->nonFinite++;
+            continue;
+        }
+
+        // One ULP is the gap above the correctly rounded float result
+        float rounded = fabsf((float)expected);
+        double ulp = (double)nextafterf(rounded, INFINITY) - rounded;
+        double absError = fabs(got - expected);
+        double ulpError = absError / ulp;
+
+        if (ulpError > stats->maxUlp) stats->maxUlp = ulpError;
+        if (absError > stats->maxAbs) stats->maxAbs = absError;
+        stats->sumUlp += ulpError;
+        stats->sumAbs += absError;
+        stats->compared++;
+    }
+}
+
+int runAccuracy(int side) {
+    GLint range[2], precision = 0;
+    glGetShaderPrecisionFormat(GL_FRAGMENT_SHADER, GL_HIGH_FLOAT, range, &precision);
+    if (precision < 23) {
+        printf("Builtin accuracy: no highp float in fragment shaders, skipped\n");
+        return 0;
+    }
+
+    // Inputs are indexed by a highp float, exact up to 2^24
+    side = platformClampTargetSide(side);
+
+    GLuint texture, framebuffer;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, side, side, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("Builtin accuracy: %dx%d RGBA8 target is incomplete, skipped\n", side, side);
+        glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+
+    float quadVertices[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    GLuint quad;
+    glGenBuffers(1, &quad);
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+    glViewport(0, 0, side, side);
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    long count = (long)side * side;
+    unsigned char *pixels = malloc(count * 4);
+    float *inputs = malloc(count * sizeof(float));
+    float *results = malloc(count * sizeof(float));
+
+    // The identity pass reads back the inputs exactly as the GPU computed them,
+    // so libm is evaluated at the same x the builtin saw.
+    GLuint inputProgram = buildBuiltinProgram(BUILTIN_COUNT, "input", "x");
+    long packMismatches = 0;
+
+    printf("Builtin accuracy, %ld highp inputs per range\n", count);
+    printf("  %-12s %-22s %10s %10s %12s %12s %9s\n", "builtin", "range", "max ulp", "mean ulp",
+           "max abs", "mean abs", "nonfinite");
+
+    for (int b = 0; b < BUILTIN_COUNT; b++) {
+        const struct AccuracyBuiltin *builtin = &builtins[b];
+        GLuint program = buildBuiltinProgram(b, builtin->name, builtin->expression);
+
+        for (int r = 0; r < builtin->rangeCount; r++) {
+            struct AccuracyRange inputRange = builtin->ranges[r];
+            evaluate(inputProgram, quad, side, inputRange, pixels, inputs);
+            evaluate(program, quad, side, inputRange, pixels, results);
+
+            // Sanity check of the packing: the read-back inputs must match a
+            // CPU evaluation of the same expression to within a few ULP.
+            float span = inputRange.xMax - inputRange.xMin;
+            for (long i = 0; i < count; i++) {
+                float x = inputRange.xMin + span * ((float)i / (float)count);
+                if (fabsf(inputs[i] - x) > 4.0f * (nextafterf(fabsf(x), INFINITY) - fabsf(x))) {
+                    packMismatches++;
+                }
+            }
+
+            struct AccuracyStats stats;
+            compare(builtin, inputs, results, count, &stats);
+
+            char rangeLabel[32];
+            snprintf(rangeLabel, sizeof(rangeLabel), "[%g, %g]", inputRange.xMin, inputRange.xMax);
+            printf("  %-12s %-22s %10.2f %10.3f %12.3e %12.3e %9ld\n", builtin->name, rangeLabel,
+                   stats.maxUlp, stats.compared ? stats.sumUlp / stats.compared : 0.0,
+                   stats.maxAbs, stats.compared ? stats.sumAbs / stats.compared : 0.0, stats.nonFinite);
+        }
+
+        glDeleteProgram(program);
+    }
+
+    if (packMismatches) {
+        printf("  %ld inputs did not survive the RGBA8 packing; results are unreliable\n", packMismatches);
+    }
+
+    free(pixels);
+    free(inputs);
+    free(results);
+    glDeleteProgram(inputProgram);
+    glDeleteBuffers(1, &quad);
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+    stateInvalidate();
+    return packMismatches == 0;
+}
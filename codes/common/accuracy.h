@@ -0,0 +1,11 @@
+#ifndef ACCURACY_H
+#define ACCURACY_H
+
+// Measures the accuracy of the GLSL builtins the suites plot against libm.
+// Every input range is evaluated in one full-screen pass over a side x side
+// target, one input per fragment. The highp result is packed into the RGBA8
+// color, read back and compared as a float. Prints the max and mean ULP and
+// absolute error per builtin and range. Returns 0 if the harness could not run.
+int runAccuracy(int side);
+
+#endif
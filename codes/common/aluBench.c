@@ -0,0 +1,204 @@
+#include "aluBench.h"
+#include "glState.h"
+#include "platform.h"
+#include "shader.h"
+#include "timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_SIZE 512
+#define BENCH_DRAWS 5
+
+// One link of the chain. Scalar chains update float x, vector chains vec3 v;
+// each step feeds its result into the next and keeps it in a range where the
+// builtin stays defined, with as little glue around the call as possible.
+struct AluBuiltin {
+    const char *name;
+    int vector;
+    const char *step;
+};
+
+static const struct AluBuiltin builtins[] = {
+    {"baseline",    0, "x * 0.9999 + 0.0001"},
+    // commonFuncs
+    {"abs",         0, "abs(x - 0.5)"},
+    {"sign",        0, "x + sign(x - 0.5) * 0.001"},
+    {"floor",       0, "floor(x * 8.0) * 0.125 + 0.0625"},
+    {"ceil",        0, "ceil(x * 8.0) * 0.125 - 0.0625"},
+    {"fract",       0, "fract(x * 1.37)"},
+    {"mod",         0, "mod(x * 1.37, 1.0)"},
+    {"min",         0, "min(x * 1.01, 0.9)"},
+    {"max",         0, "max(x * 0.99, 0.1)"},
+    {"clamp",       0, "clamp(x * 1.01, 0.1, 0.9)"},
+    {"mix",         0, "mix(x, 0.5, 0.1)"},
+    {"step",        0, "x * 0.5 + step(0.5, x) * 0.25"},
+    {"smoothstep",  0, "smoothstep(0.0, 1.0, x)"},
+    // exponential
+    {"pow",         0, "pow(x, 1.1)"},
+    {"exp",         0, "exp(-x)"},
+    {"exp2",        0, "exp2(-x)"},
+    {"log",         0, "log(x + 1.0)"},
+    {"log2",        0, "log2(x + 1.0)"},
+    {"sqrt",        0, "sqrt(x)"},
+    {"inversesqrt", 0, "inversesqrt(x + 1.0)"},
+    // angle&trigonometry
+    {"radians",     0, "radians(x * 50.0)"},
+    {"sin",         0, "sin(x)"},
+    {"cos",         0, "cos(x)"},
+    {"tan",         0, "tan(x * 0.7)"},
+    {"asin",        0, "asin(x * 0.8)"},
+    {"acos",        0, "acos(x) * 0.6"},
+    {"atan",        0, "atan(x)"},
+    // geometricFuncs
+    {"length",      0, "length(vec3(x, 0.5, 0.25)) * 0.5"},
+    {"distance",    0, "distance(vec3(x, 0.5, 0.25), vec3(0.1)) * 0.5"},
+    {"dot",         0, "dot(vec3(x, 0.5, 0.25), vec3(0.6, 0.3, 0.2))"},
+    {"cross",       1, "cross(v, vec3(0.6, 0.8, 0.0)) + 0.1"},
+    {"normalize",   1, "normalize(v + 0.1)"},
+    {"faceforward", 1, "faceforward(v, vec3(0.6, 0.8, 0.0), v.zxy) * 0.9"},
+    {"reflect",     1, "reflect(v, vec3(0.0, 0.6, 0.8))"},
+    {"refract",     1, "refract(v, vec3(0.0, 0.6, 0.8), 0.9) + 0.05"},
+};
+
+#define BUILTIN_COUNT (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+static const char *precisions[] = {"lowp", "mediump", "highp"};
+
+#define PRECISION_COUNT 3
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec2 aPos;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "}";
+
+static const char *const attribNames[] = {"aPos", NULL};
+
+// The seed comes from gl_FragCoord and a uniform so nothing can be folded at
+// compile time, and the result reaches the color so nothing is dead code.
+static char *fragmentSource(const struct AluBuiltin *builtin, const char *precision, int chainLength) {
+    const char *prologue =
+        "#version 100\n"
+        "precision %s float;\n"
+        "uniform vec2 uSeed;\n"
+        "void main() {\n"
+        "    float x = fract(dot(gl_FragCoord.xy, uSeed)) * 0.5 + 0.25;\n"
+        "    vec3 v = vec3(x, 1.0 - x, 0.5);\n";
+    const char *epilogue =
+        "    gl_FragColor = vec4(v, x);\n"
+        "}";
+
+    size_t stepLength = strlen(builtin->step) + 16;
+    char *source = malloc(strlen(prologue) + 16 + stepLength * chainLength + strlen(epilogue) + 1);
+    char *end = source + sprintf(source, prologue, precision);
+
+    for (int i = 0; i < chainLength; i++) {
+        end += sprintf(end, "    %s = %s;\n", builtin->vector ? "v" : "x", builtin->step);
+    }
+    strcpy(end, epilogue);
+    return source;
+}
+
+// Median time of one full-screen pass, after a warmup pass that also
+// absorbs any compilation the driver deferred to the first draw.
+static double timePasses(GLuint program, GLuint quad) {
+    double times[BENCH_DRAWS];
+
+    stateUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "uSeed"), 0.0137f, 0.0291f);
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    stateVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(0);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glFinish();
+
+    for (int i = 0; i < BENCH_DRAWS; i++) {
+        double start = timeNowMs();
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glFinish();
+        times[i] = timeNowMs() - start;
+    }
+
+    sortTimings(times, BENCH_DRAWS);
+    return timingPercentile(times, BENCH_DRAWS, 0.5);
+}
+
+int runAluBench(int chainLength) {
+    if (chainLength <= 0) {
+        return 1;
+    }
+
+    GLint range[2], highpBits = 0;
+    glGetShaderPrecisionFormat(GL_FRAGMENT_SHADER, GL_HIGH_FLOAT, range, &highpBits);
+
+    GLuint texture, framebuffer;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, BENCH_SIZE, BENCH_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    float quadVertices[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    GLuint quad;
+    glGenBuffers(1, &quad);
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+    glViewport(0, 0, BENCH_SIZE, BENCH_SIZE);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+
+    double ops = (double)BENCH_SIZE * BENCH_SIZE * chainLength;
+    int failures = 0;
+
+    printf("ALU throughput, chains of %d calls over %dx%d fragments (Gops/s, median of %d passes)\n",
+           chainLength, BENCH_SIZE, BENCH_SIZE, BENCH_DRAWS);
+    printf("  %-12s %10s %10s %10s\n", "builtin", precisions[0], precisions[1], precisions[2]);
+
+    for (int b = 0; b < BUILTIN_COUNT; b++) {
+        printf("  %-12s", builtins[b].name);
+
+        for (int p = 0; p < PRECISION_COUNT; p++) {
+            // highp is optional in fragment shaders
+            if (p == 2 && highpBits == 0) {
+                printf(" %10s", "-");
+                continue;
+            }
+
+            // Every builtin, precision and chain length is a program used once, and
+            // the precision columns must stay as written whatever --precision says
+            char name[64];
+            snprintf(name, sizeof(name), "aluBench.%s.%s", builtins[b].name, precisions[p]);
+            char *source = fragmentSource(&builtins[b], precisions[p], chainLength);
+            GLuint program = linkUncachedProgram(name, vertexSource, source, attribNames);
+            free(source);
+
+            if (!program) {
+                printf(" %10s", "FAILED");
+                failures++;
+                continue;
+            }
+
+            double ms = timePasses(program, quad);
+            printf(" %10.2f", ms > 0.0 ? ops / (ms * 1e6) : 0.0);
+            glDeleteProgram(program);
+        }
+        printf("\n");
+    }
+
+    glDeleteBuffers(1, &quad);
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+    stateInvalidate();
+    return failures == 0;
+}
@@ -0,0 +1,11 @@
+#ifndef ALU_BENCH_H
+#define ALU_BENCH_H
+
+// For every builtin the suites exercise and every float precision, renders
+// full-screen passes whose fragment shader runs a dependent chain of
+// chainLength calls, and prints the throughput in Gops/s (builtin calls per
+// second). A "baseline" row times a plain multiply-add chain for reference.
+// Returns 0 if a benchmark shader failed to build.
+int runAluBench(int chainLength);
+
+#endif
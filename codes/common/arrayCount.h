@@ -0,0 +1,7 @@
+#ifndef ARRAY_COUNT_H
+#define ARRAY_COUNT_H
+
+// Number of elements of a fixed-size array (not a pointer).
+#define COUNT(array) (int)(sizeof(array) / sizeof(array[0]))
+
+#endif
@@ -0,0 +1,199 @@
+#include "curve.h"
+#include "glState.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Intervals the range is cut into before adaptive subdivision starts, so a
+// feature narrower than the whole range cannot hide between two samples.
+#define CURVE_START_INTERVALS 16
+#define CURVE_MAX_DEPTH 24
+
+struct Sampler {
+    float (*f)(float);
+    float pixelsPerX;
+    float pixelsPerY;
+    float maxError;
+    float *points;
+    int count;
+    int capacity;
+    int *runs;
+    int runCount;
+    int runCapacity;
+};
+
+static int samples = 256;
+static float plotError = 0.0f;
+static float fanStep = 5.0f;
+
+int curveParseArg(const char *arg, const char *value) {
+    if (!value) {
+        return 0;
+    }
+
+    if (strcmp(arg, "--curve-samples") == 0) {
+        samples = atoi(value);
+        if (samples < 2) samples = 2;
+        return 2;
+    }
+
+    if (strcmp(arg, "--plot-error") == 0) {
+        plotError = (float)atof(value);
+        if (plotError < 0.0f) plotError = 0.0f;
+        return 2;
+    }
+
+    if (strcmp(arg, "--fan-step") == 0) {
+        fanStep = (float)atof(value);
+        if (fanStep < 0.001f) fanStep = 0.001f;
+        return 2;
+    }
+
+    return 0;
+}
+
+int curveSamples() {
+    return samples;
+}
+
+float curvePlotError() {
+    return plotError;
+}
+
+float curveFanStep() {
+    return fanStep;
+}
+
+static void upload(struct Curve *curve, const float *vertices, int count, GLenum mode) {
+    glGenBuffers(1, &curve->vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, curve->vbo);
+    glBufferData(GL_ARRAY_BUFFER, count * 3 * sizeof(float), vertices, GL_STATIC_DRAW);
+    curve->mode = mode;
+    curve->count = count;
+    curve->runs = NULL;
+    curve->runCount = 0;
+}
+
+void curveCreate(struct Curve *curve, float xMin, float xMax, int count) {
+    if (count < 2) count = 2;
+
+    float *vertices = malloc(count * 3 * sizeof(float));
+    for (int i = 0; i < count; i++) {
+        vertices[i * 3] = xMin + (xMax - xMin) * i / (count - 1);
+        vertices[i * 3 + 1] = 0.0f;
+        vertices[i * 3 + 2] = 0.0f;
+    }
+
+    upload(curve, vertices, count, GL_LINE_STRIP);
+    free(vertices);
+}
+
+static void emitPoint(struct Sampler *sampler, float x) {
+    if (sampler->count == sampler->capacity) {
+        sampler->capacity = sampler->capacity ? sampler->capacity * 2 : 64;
+        sampler->points = realloc(sampler->points, sampler->capacity * sizeof(float));
+    }
+    sampler->points[sampler->count++] = x;
+}
+
+// Segments arrive in increasing x, so one that starts where the last ended
+// extends the current run; a gap means a piece was left out and starts a new one.
+static void emitSegment(struct Sampler *sampler, float a, float b) {
+    if (sampler->runCount == 0 || sampler->points[sampler->count - 1] != a) {
+        if (sampler->runCount == sampler->runCapacity) {
+            sampler->runCapacity = sampler->runCapacity ? sampler->runCapacity * 2 : 8;
+            sampler->runs = realloc(sampler->runs, sampler->runCapacity * sizeof(int));
+        }
+        sampler->runs[sampler->runCount++] = 0;
+        emitPoint(sampler, a);
+        sampler->runs[sampler->runCount - 1]++;
+    }
+
+    emitPoint(sampler, b);
+    sampler->runs[sampler->runCount - 1]++;
+}
+
+static void subdivide(struct Sampler *sampler, float a, float fa, float b, float fb, int depth) {
+    float m = 0.5f * (a + b);
+    float fm = sampler->f(m);
+    int finite = isfinite(fa) && isfinite(fb) && isfinite(fm);
+
+    if (finite && ((fa > 1.0f && fm > 1.0f && fb > 1.0f) || (fa < -1.0f && fm < -1.0f && fb < -1.0f))) {
+        return;
+    }
+
+    float error = finite ? fabsf(fm - 0.5f * (fa + fb)) * sampler->pixelsPerY : INFINITY;
+    int splittable = depth < CURVE_MAX_DEPTH && (b - a) * sampler->pixelsPerX > 0.25f;
+
+    if (error > sampler->maxError && splittable) {
+        subdivide(sampler, a, fa, m, fm, depth + 1);
+        subdivide(sampler, m, fm, b, fb, depth + 1);
+    } else if (isfinite(fa) && isfinite(fb)) {
+        emitSegment(sampler, a, b);
+    }
+}
+
+int curveSampleAdaptive(float (*f)(float), float xMin, float xMax, float pixelsPerX, float pixelsPerY,
+                        float maxError, float **points, int **runs, int *runCount) {
+    struct Sampler sampler = {f, pixelsPerX, pixelsPerY, maxError, NULL, 0, 0, NULL, 0, 0};
+
+    float a = xMin;
+    float fa = f(a);
+    for (int i = 1; i <= CURVE_START_INTERVALS; i++) {
+        float b = xMin + (xMax - xMin) * i / CURVE_START_INTERVALS;
+        float fb = f(b);
+        subdivide(&sampler, a, fa, b, fb, 0);
+        a = b;
+        fa = fb;
+    }
+
+    *points = sampler.points;
+    *runs = sampler.runs;
+    *runCount = sampler.runCount;
+    return sampler.count;
+}
+
+void curveCreateAdaptive(struct Curve *curve, float (*f)(float), float xMin, float xMax,
+                         float pixelsPerX, float pixelsPerY, float maxError) {
+    float *points;
+    int *runs, runCount;
+    int count = curveSampleAdaptive(f, xMin, xMax, pixelsPerX, pixelsPerY, maxError, &points, &runs, &runCount);
+
+    // Nothing in view leaves an empty buffer and no runs to draw
+    float *vertices = NULL;
+    if (count > 0) {
+        vertices = calloc(count * 3, sizeof(float));
+        for (int i = 0; i < count; i++) {
+            vertices[i * 3] = points[i];
+        }
+    }
+
+    upload(curve, vertices, count, GL_LINE_STRIP);
+    curve->runs = runs;
+    curve->runCount = runCount;
+    free(vertices);
+    free(points);
+}
+
+void curveDraw(const struct Curve *curve) {
+    if (!curve->runs) {
+        glDrawArrays(curve->mode, 0, curve->count);
+        return;
+    }
+
+    int first = 0;
+    for (int i = 0; i < curve->runCount; i++) {
+        glDrawArrays(curve->mode, first, curve->runs[i]);
+        first += curve->runs[i];
+    }
+}
+
+void curveDestroy(struct Curve *curve) {
+    glDeleteBuffers(1, &curve->vbo);
+    free(curve->runs);
+    curve->vbo = 0;
+    curve->count = 0;
+    curve->runs = NULL;
+    curve->runCount = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef CURVE_H
+#define CURVE_H
+
+#include <GLES2/gl2.h>
+
+// A plot in one vertex buffer. curveCreate() samples x uniformly over
+// [xMin, xMax] and uploads aPos = (x, 0, 0) as one GL_LINE_STRIP;
+// curveCreateAdaptive() uploads the runs picked by curveSampleAdaptive() back
+// to back, each drawn as its own strip. Either way the vertex shader turns
+// each x into a point of the curve.
+struct Curve {
+    GLuint vbo;
+    GLenum mode;
+    int count;
+    int *runs;          // vertices per strip, or NULL to draw all count at once
+    int runCount;
+};
+
+// --curve-samples N sets how many samples uniform curves get (default 256),
+// --plot-error PX switches plots to adaptive sampling with at most PX pixels
+// of error (default 0, uniform sampling) and --fan-step DEG sets the angle
+// between the spokes of radial fans (default 5).
+// Returns how many arguments it consumed.
+int curveParseArg(const char *arg, const char *value);
+int curveSamples();
+float curvePlotError();
+float curveFanStep();
+
+void curveCreate(struct Curve *curve, float xMin, float xMax, int samples);
+
+// Subdivides [xMin, xMax] wherever the chord through f strays more than
+// maxError pixels from f at its midpoint, with one unit spanning pixelsPerX
+// and pixelsPerY pixels on screen (y in clip space). Pieces where f is not
+// finite or that stay entirely above or below the viewport are left out, which
+// breaks the polyline there. Stores the x of every point in a malloc'd array in
+// *points, the number of points of each unbroken run in a malloc'd array in
+// *runs and their count in *runCount, and returns the number of points (0 and
+// no runs if nothing is in view). Points where two segments meet are stored
+// once.
+int curveSampleAdaptive(float (*f)(float), float xMin, float xMax, float pixelsPerX, float pixelsPerY,
+                        float maxError, float **points, int **runs, int *runCount);
+void curveCreateAdaptive(struct Curve *curve, float (*f)(float), float xMin, float xMax,
+                         float pixelsPerX, float pixelsPerY, float maxError);
+
+// Draws every run of the curve; the buffer and attributes must be bound.
+void curveDraw(const struct Curve *curve);
+void curveDestroy(struct Curve *curve);
+
+#endif
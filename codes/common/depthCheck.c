@@ -0,0 +1,211 @@
+#include "depthCheck.h"
+#include "arrayCount.h"
+#include "depthReadback.h"
+#include "depthRef.h"
+#include "glState.h"
+#include "platform.h"
+#include "raster.h"
+#include "shader.h"
+#include "timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const GLenum funcs[] = {
+    GL_NEVER, GL_LESS, GL_LEQUAL, GL_GREATER, GL_GEQUAL, GL_EQUAL, GL_NOTEQUAL, GL_ALWAYS,
+};
+
+struct DepthRange {
+    float near, far;
+};
+
+static const struct DepthRange ranges[] = {
+    {0.0f, 1.0f}, {1.0f, 0.0f}, {0.25f, 0.75f}, {0.9f, 0.1f},
+    {0.5f, 0.5f}, {0.0f, 1.0f / 1024.0f}, {0.999f, 1.0f},
+};
+
+// Stored where neither triangle is drawn, and what the functions compare with there
+#define CLEAR_DEPTH 0.5f
+
+// Normalized device coordinates. The quad's corners are not coplanar, so its
+// two triangles interpolate different planes; the crossing triangle is above
+// the quad at one end and below it at the other.
+static const float quad[6][3] = {
+    {-0.75f, -0.75f, -0.9f}, {0.75f, -0.75f, 0.3f}, {-0.75f, 0.75f, 0.95f},
+    {0.75f, -0.75f, 0.3f}, {0.75f, 0.75f, -0.2f}, {-0.75f, 0.75f, 0.95f},
+};
+static const float crossing[3][3] = {
+    {-0.97f, -0.93f, 0.8f}, {0.96f, -0.4f, -0.85f}, {0.05f, 0.98f, 0.1f},
+};
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec3 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 1.0);\n"
+    "}";
+
+static const char *fragmentSource =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(1.0);\n"
+    "}";
+
+struct ModelContext {
+    uint32_t *depth, *z;
+    unsigned char *pass;
+    int side;
+    GLenum func;
+    const float *plane;
+    float scale;
+};
+
+static void modelSpan(void *context, int y, int x0, int x1) {
+    struct ModelContext *model = context;
+    uint32_t *row = model->depth + (size_t)y * model->side + x0;
+    depthRefSpan(model->func, model->plane, model->scale, x0, y, row, model->z, model->pass, x1 - x0);
+    depthRefStore(row, model->z, model->pass, x1 - x0);
+}
+
+// Runs triangles (NDC) through the model with the depth test func
+static void modelTriangles(struct ModelContext *model, const float (*vertices)[3], int count,
+                           const struct DepthRange *range, GLenum func) {
+    for (int t = 0; t < count; t += 3) {
+        float v[3][3];
+        for (int i = 0; i < 3; i++) {
+            v[i][0] = (vertices[t + i][0] + 1.0f) * 0.5f * model->side;
+            v[i][1] = (vertices[t + i][1] + 1.0f) * 0.5f * model->side;
+            v[i][2] = range->near + (vertices[t + i][2] + 1.0f) * 0.5f * (range->far - range->near);
+        }
+
+        float plane[3];
+        rasterPlane(v[0], v[1], v[2], v[0][2], v[1][2], v[2][2], plane);
+        model->func = func;
+        model->plane = plane;
+        rasterTriangle(v[0], v[1], v[2], 0, 0, model->side, model->side, modelSpan, model);
+    }
+}
+
+int runDepthCheck(int side) {
+    side = platformClampTargetSide(side);
+
+    struct DepthTarget target;
+    if (!depthTargetCreate(&target, side, side)) {
+        printf("Depth check: no %dx%d depth texture target with highp readback, skipped\n", side, side);
+        glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+        return 0;
+    }
+
+    GLuint program = buildProgram("depthCheck", vertexSource, fragmentSource);
+    GLuint posAttrib = programAttrib(program, "aPosition");
+    GLuint buffer;
+    float vertices[9][3];
+    for (int i = 0; i < 6; i++) {
+        vertices[i][0] = quad[i][0], vertices[i][1] = quad[i][1], vertices[i][2] = quad[i][2];
+    }
+    for (int i = 0; i < 3; i++) {
+        vertices[6 + i][0] = crossing[i][0], vertices[6 + i][1] = crossing[i][1], vertices[6 + i][2] = crossing[i][2];
+    }
+    glGenBuffers(1, &buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    size_t pixels = (size_t)side * side;
+    uint32_t *expected = malloc(pixels * sizeof(uint32_t));
+    uint32_t *actual = malloc(pixels * sizeof(uint32_t));
+    struct ModelContext model;
+    model.depth = expected;
+    model.z = malloc(side * sizeof(uint32_t));
+    model.pass = malloc(side);
+    model.side = side;
+    model.scale = depthRefScale(target.bits);
+    uint32_t tolerance = depthRefTolerance(target.bits);
+
+    double drawMs = 0.0, readMs = 0.0, modelMs = 0.0;
+    long failed = 0;
+
+    printf("Depth check, %d depth ranges x %d functions, %dx%d %d-bit depth texture, tolerance %u steps\n",
+           COUNT(ranges), COUNT(funcs), side, side, target.bits, tolerance);
+
+    for (int r = 0; r < COUNT(ranges); r++) {
+        const struct DepthRange *range = &ranges[r];
+        long inexact = 0, mismatched = 0;
+        uint32_t maxError = 0;
+
+        for (int f = 0; f < COUNT(funcs); f++) {
+            // depthReadback() draws with its own program and state
+            double start = timeNowMs();
+            stateUseProgram(program);
+            stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+            stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            stateEnableVertexAttribArray(posAttrib);
+            glViewport(0, 0, side, side);
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glDepthMask(GL_TRUE);
+            glClearDepthf(CLEAR_DEPTH);
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            glDepthRangef(range->near, range->far);
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_ALWAYS);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glDepthFunc(funcs[f]);
+            glDrawArrays(GL_TRIANGLES, 6, 3);
+            glFinish();
+            double drawn = timeNowMs();
+
+            depthReadback(&target, 0, 0, side, side, actual);
+            double read = timeNowMs();
+
+            uint32_t cleared = depthRefQuantize(CLEAR_DEPTH, model.scale);
+            for (size_t i = 0; i < pixels; i++) {
+                expected[i] = cleared;
+            }
+            modelTriangles(&model, quad, 6, range, GL_ALWAYS);
+            modelTriangles(&model, crossing, 3, range, funcs[f]);
+            double modelled = timeNowMs();
+
+            for (size_t i = 0; i < pixels; i++) {
+                uint32_t error = actual[i] > expected[i] ? actual[i] - expected[i] : expected[i] - actual[i];
+                if (error) {
+                    inexact++;
+                    mismatched += error > tolerance;
+                    if (error > maxError) maxError = error;
+                }
+            }
+
+            drawMs += drawn - start;
+            readMs += read - drawn;
+            modelMs += modelled - read;
+        }
+
+        printf("  range [%g, %g]: %s, %.1f%% exact, %ld pixels over the tolerance, max error %u\n",
+               range->near, range->far, mismatched ? "FAIL" : "PASS",
+               100.0 - 100.0 * inexact / ((double)pixels * COUNT(funcs)), mismatched, maxError);
+        failed += mismatched > 0;
+    }
+
+    int cases = COUNT(ranges) * COUNT(funcs);
+    printf("  %d/%d ranges match depthRef; per case: draw %.2f ms, depth readback %.2f ms, model %.2f ms\n",
+           COUNT(ranges) - (int)failed, COUNT(ranges), drawMs / cases, readMs / cases, modelMs / cases);
+
+    free(expected);
+    free(actual);
+    free(model.z);
+    free(model.pass);
+    stateDisableVertexAttribArray(posAttrib);
+    glDeleteBuffers(1, &buffer);
+    glDeleteProgram(program);
+    depthReadbackRelease();
+
+    glDepthRangef(0.0f, 1.0f);
+    glDepthFunc(GL_LESS);
+    glClearDepthf(1.0f);
+    glDisable(GL_DEPTH_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    depthTargetDelete(&target);
+    stateInvalidate();
+    return failed == 0;
+}
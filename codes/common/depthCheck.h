@@ -0,0 +1,17 @@
+#ifndef DEPTH_CHECK_H
+#define DEPTH_CHECK_H
+
+// Checks the stored depth values themselves against depthRef, not the colors
+// that survive the depth test. For each glDepthRangef setting in a table
+// (full, reversed, narrow, collapsed and at either end) and each of the 8
+// depth functions, a side x side depth texture target is cleared, a quad of
+// two differently sloped triangles is drawn with GL_ALWAYS and a triangle
+// crossing it with the function under test. The depth is read back with
+// depthReadback() and compared, pixel for pixel, with the CPU model; the
+// share of exact values and the largest error in steps of the buffer are
+// printed per range. Interpolation may round differently from the model, so a
+// value fails when it is off by more than 2^-21 of the range (8 steps of a
+// 24-bit buffer). Returns 0 if one fails or the target cannot be made.
+int runDepthCheck(int side);
+
+#endif
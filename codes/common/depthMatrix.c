@@ -0,0 +1,532 @@
+#include "depthMatrix.h"
+#include "arrayCount.h"
+#include "depthReadback.h"
+#include "depthRef.h"
+#include "glState.h"
+#include "platform.h"
+#include "raster.h"
+#include "shader.h"
+#include "timing.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TILE 32
+#define MAX_REPORTED 10
+#define LAYERS 8
+#define TIMING_REPEATS 3
+
+static const GLenum funcs[] = {
+    GL_NEVER, GL_LESS, GL_LEQUAL, GL_GREATER, GL_GEQUAL, GL_EQUAL, GL_NOTEQUAL, GL_ALWAYS,
+};
+
+struct DepthRange {
+    float near, far;
+};
+
+struct PolygonOffset {
+    int enabled;
+    float factor, units;
+};
+
+static const float clearDepths[] = {0.0f, 0.4f, 1.0f};
+static const struct DepthRange ranges[] = {{0.0f, 1.0f}, {1.0f, 0.0f}, {0.2f, 0.6f}, {0.5f, 0.5f}};
+static const GLboolean masks[] = {GL_TRUE, GL_FALSE};
+static const struct PolygonOffset offsets[] = {{0, 0.0f, 0.0f}, {1, 0.0f, -64.0f}, {1, 1.0f, 32.0f}};
+
+#define CONFIG_COUNT (COUNT(funcs) * COUNT(clearDepths) * COUNT(ranges) * COUNT(masks) * COUNT(offsets))
+
+struct MatrixConfig {
+    int func;                   // index into funcs
+    float clearDepth;
+    struct DepthRange range;
+    GLboolean mask;
+    struct PolygonOffset offset;
+};
+
+static struct MatrixConfig configAt(int index) {
+    struct MatrixConfig config;
+    config.func = index % COUNT(funcs);
+    index /= COUNT(funcs);
+    config.clearDepth = clearDepths[index % COUNT(clearDepths)];
+    index /= COUNT(clearDepths);
+    config.range = ranges[index % COUNT(ranges)];
+    index /= COUNT(ranges);
+    config.mask = masks[index % COUNT(masks)];
+    index /= COUNT(masks);
+    config.offset = offsets[index];
+    return config;
+}
+
+static const char *funcName(GLenum func) {
+    switch (func) {
+    case GL_NEVER: return "NEVER";
+    case GL_LESS: return "LESS";
+    case GL_LEQUAL: return "LEQUAL";
+    case GL_GREATER: return "GREATER";
+    case GL_GEQUAL: return "GEQUAL";
+    case GL_EQUAL: return "EQUAL";
+    case GL_NOTEQUAL: return "NOTEQUAL";
+    default: return "ALWAYS";
+    }
+}
+
+// Normalized device coordinates: a quad of two planes and a triangle that
+// crosses it, reaching past it onto the cleared depth. A tile is small, so
+// the depths stay within 0.1 of the middle of the range: steep planes far
+// from the origin are where GPUs round their interpolation the most.
+static const float quad[6][3] = {
+    {-0.75f, -0.75f, -0.09f}, {0.75f, -0.75f, 0.03f}, {-0.75f, 0.75f, 0.095f},
+    {0.75f, -0.75f, 0.03f}, {0.75f, 0.75f, -0.02f}, {-0.75f, 0.75f, 0.095f},
+};
+static const float crossing[3][3] = {
+    {-0.97f, -0.93f, 0.08245f}, {0.96f, -0.4f, -0.0816f}, {0.05f, 0.98f, -0.00425f},
+};
+static const float fullQuad[6][3] = {
+    {-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f},
+    {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f},
+};
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec3 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 1.0);\n"
+    "}";
+
+static const char *fragmentSource =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);\n"
+    "}";
+
+// The overdraw layers: a full-target quad at depth uZ, with enough ALU work
+// per fragment that shading a rejected fragment shows in the time
+static const char *layerVertexSource =
+    "#version 100\n"
+    "attribute vec3 aPosition;\n"
+    "uniform float uZ;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition.xy, uZ, 1.0);\n"
+    "}";
+
+static const char *layerFragmentSource =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "uniform vec3 uColor;\n"
+    "void main() {\n"
+    "    vec3 c = uColor;\n"
+    "    for (int i = 0; i < 16; i++) {\n"
+    "        c = fract(c * 1.37 + vec3(0.11, 0.23, 0.37));\n"
+    "    }\n"
+    "    gl_FragColor = vec4(c, 1.0);\n"
+    "}";
+
+struct TileModel {
+    uint32_t depth[TILE * TILE];
+    unsigned char pass[TILE * TILE];        // the crossing triangle wrote red
+    unsigned char unsure[TILE * TILE];      // too close to call, not compared
+    uint32_t z[TILE];
+    unsigned char spanPass[TILE];
+    GLenum func;
+    GLboolean mask;
+    const float *plane;
+    float scale;
+    uint32_t baseTolerance;                 // depthRefTolerance()
+    uint32_t tolerance;                     // with the slack of the planes drawn so far
+    int crossing;
+    int tileX, tileY;                       // where the tile is in the target
+};
+
+static void modelSpan(void *context, int y, int x0, int x1) {
+    struct TileModel *model = context;
+    int at = (y - model->tileY) * TILE + x0 - model->tileX, count = x1 - x0;
+    depthRefSpan(model->func, model->plane, model->scale, x0, y, model->depth + at, model->z, model->spanPass, count);
+
+    if (model->crossing) {
+        for (int i = 0; i < count; i++) {
+            uint32_t stored = model->depth[at + i];
+            uint32_t distance = model->z[i] > stored ? model->z[i] - stored : stored - model->z[i];
+            model->pass[at + i] = model->spanPass[i];
+            model->unsure[at + i] = model->func != GL_ALWAYS && model->func != GL_NEVER &&
+                                    distance > 0 && distance <= model->tolerance * 2;
+        }
+    }
+    if (model->mask) {
+        depthRefStore(model->depth + at, model->z, model->spanPass, count);
+    }
+}
+
+static void modelTriangles(struct TileModel *model, const float (*vertices)[3], int count,
+                           const struct DepthRange *range, float offset) {
+    for (int t = 0; t < count; t += 3) {
+        float v[3][3];
+        for (int i = 0; i < 3; i++) {
+            v[i][0] = model->tileX + (vertices[t + i][0] + 1.0f) * 0.5f * TILE;
+            v[i][1] = model->tileY + (vertices[t + i][1] + 1.0f) * 0.5f * TILE;
+            v[i][2] = 0.5f * (range->far - range->near) * vertices[t + i][2] + 0.5f * (range->near + range->far);
+        }
+
+        float plane[3];
+        rasterPlane(v[0], v[1], v[2], v[0][2], v[1][2], v[2][2], plane);
+        plane[2] += offset;
+        model->plane = plane;
+
+        uint32_t slack = depthRefPlaneSlack(plane, model->tileX + TILE, model->tileY + TILE, model->scale);
+        if (model->tolerance < model->baseTolerance + slack) {
+            model->tolerance = model->baseTolerance + slack;
+        }
+        rasterTriangle(v[0], v[1], v[2], model->tileX, model->tileY, model->tileX + TILE, model->tileY + TILE,
+                       modelSpan, model);
+    }
+}
+
+// The polygon offset of the crossing triangle in window z: factor times its
+// slope per pixel (it has none along y, so every allowed way of measuring it
+// agrees) plus units times the GPU's resolvable step, measured in steps
+static float offsetOf(const struct MatrixConfig *config, float scale, float unitSteps) {
+    if (!config->offset.enabled) {
+        return 0.0f;
+    }
+
+    float v[3][3], plane[3];
+    for (int i = 0; i < 3; i++) {
+        v[i][0] = (crossing[i][0] + 1.0f) * 0.5f * TILE;
+        v[i][1] = (crossing[i][1] + 1.0f) * 0.5f * TILE;
+        v[i][2] = 0.5f * (config->range.far - config->range.near) * crossing[i][2] +
+                  0.5f * (config->range.near + config->range.far);
+    }
+    rasterPlane(v[0], v[1], v[2], v[0][2], v[1][2], v[2][2], plane);
+    float slope = fmaxf(fabsf(plane[0]), fabsf(plane[1]));
+    return config->offset.factor * slope + config->offset.units * unitSteps / scale;
+}
+
+// depthReadback() draws with its own program and buffer, so this is redone after it
+static void bindMatrixProgram(GLuint program, GLuint buffer, GLuint posAttrib) {
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+}
+
+// GLES2 leaves the size of a polygon offset unit to the implementation (at
+// least one step); it is measured on a flat quad with a large units value
+#define CALIBRATION_UNITS 1024.0f
+
+static float measureOffsetUnit(const struct DepthTarget *target, GLuint program, GLuint buffer, GLuint posAttrib,
+                               uint32_t *depth) {
+    uint32_t measured[2];
+    for (int pass = 0; pass < 2; pass++) {
+        bindMatrixProgram(program, buffer, posAttrib);
+        glViewport(0, 0, TILE, TILE);
+        glEnable(GL_DEPTH_TEST);
+        glDepthRangef(0.0f, 1.0f);
+        glDepthFunc(GL_ALWAYS);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        if (pass) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(0.0f, CALIBRATION_UNITS);
+        }
+        glDrawArrays(GL_TRIANGLES, 9, 6);
+        glDisable(GL_POLYGON_OFFSET_FILL);
+
+        depthReadback(target, TILE / 2, TILE / 2, 1, 1, depth);
+        measured[pass] = depth[0];
+    }
+    return ((float)measured[1] - (float)measured[0]) / CALIBRATION_UNITS;
+}
+
+static void drawTile(const struct MatrixConfig *config, int x, int y) {
+    glViewport(x, y, TILE, TILE);
+    glScissor(x, y, TILE, TILE);
+    glDepthRangef(config->range.near, config->range.far);
+
+    glDepthMask(GL_TRUE);
+    glClearDepthf(config->clearDepth);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthFunc(GL_ALWAYS);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glColorMask(GL_TRUE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthFunc(funcs[config->func]);
+    glDepthMask(config->mask);
+    if (config->offset.enabled) {
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(config->offset.factor, config->offset.units);
+    }
+    glDrawArrays(GL_TRIANGLES, 6, 3);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+}
+
+// Returns 1 if every compared pixel of the tile matches the model
+static int checkTile(const struct MatrixConfig *config, const unsigned char *color, const uint32_t *depth,
+                     int side, int x0, int y0, float scale, uint32_t tolerance, float unitSteps, long *compared) {
+    static struct TileModel model;
+    model.scale = scale;
+    model.baseTolerance = tolerance;
+    model.tolerance = tolerance;
+    model.tileX = x0;
+    model.tileY = y0;
+
+    uint32_t cleared = depthRefQuantize(config->clearDepth, scale);
+    for (int i = 0; i < TILE * TILE; i++) {
+        model.depth[i] = cleared;
+    }
+    memset(model.pass, 0, sizeof(model.pass));
+    memset(model.unsure, 0, sizeof(model.unsure));
+
+    model.crossing = 0;
+    model.func = GL_ALWAYS;
+    model.mask = GL_TRUE;
+    modelTriangles(&model, quad, 6, &config->range, 0.0f);
+
+    model.crossing = 1;
+    model.func = funcs[config->func];
+    model.mask = config->mask;
+    modelTriangles(&model, crossing, 3, &config->range, offsetOf(config, scale, unitSteps));
+
+    for (int y = 0; y < TILE; y++) {
+        for (int x = 0; x < TILE; x++) {
+            int i = y * TILE + x;
+            if (model.unsure[i]) {
+                continue;
+            }
+
+            size_t at = (size_t)(y0 + y) * side + x0 + x;
+            uint32_t actual = depth[at];
+            uint32_t error = actual > model.depth[i] ? actual - model.depth[i] : model.depth[i] - actual;
+            (*compared)++;
+            if ((color[at * 4] > 127) != (model.pass[i] != 0) || error > model.tolerance) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+// Layers drawn at z0, z0 + step, ... (NDC) over a depth buffer cleared to clearDepth
+struct LayerRun {
+    float clearDepth, z0, step;
+};
+
+// How to make each function pass every layer and reject every layer; a run
+// with step 0 and clear depth 0.5 puts every layer exactly on the cleared depth
+struct TimingCase {
+    GLenum func;
+    int canPass, canReject;
+    struct LayerRun pass, reject;
+};
+
+static const struct TimingCase timingCases[] = {
+    {GL_ALWAYS,   1, 0, {1.0f, 0.9f, -0.1f}, {0.0f, 0.0f, 0.0f}},
+    {GL_NEVER,    0, 1, {0.0f, 0.0f, 0.0f}, {1.0f, 0.9f, -0.1f}},
+    {GL_LESS,     1, 1, {1.0f, 0.9f, -0.1f}, {0.0f, -0.9f, 0.1f}},
+    {GL_LEQUAL,   1, 1, {1.0f, 0.9f, -0.1f}, {0.0f, -0.9f, 0.1f}},
+    {GL_GREATER,  1, 1, {0.0f, -0.9f, 0.1f}, {1.0f, 0.9f, -0.1f}},
+    {GL_GEQUAL,   1, 1, {0.0f, -0.9f, 0.1f}, {1.0f, 0.9f, -0.1f}},
+    {GL_EQUAL,    1, 1, {0.5f, 0.0f, 0.0f}, {1.0f, 0.9f, -0.1f}},
+    {GL_NOTEQUAL, 1, 1, {1.0f, 0.9f, -0.1f}, {0.5f, 0.0f, 0.0f}},
+};
+
+// Milliseconds per full-target layer, the best of TIMING_REPEATS runs
+static double timeLayers(GLenum func, GLboolean mask, const struct LayerRun *run, GLint zUniform) {
+    double best = 0.0;
+    for (int repeat = 0; repeat < TIMING_REPEATS; repeat++) {
+        glDepthMask(GL_TRUE);
+        glClearDepthf(run->clearDepth);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glDepthFunc(func);
+        glDepthMask(mask);
+        glFinish();
+
+        double start = timeNowMs();
+        for (int layer = 0; layer < LAYERS; layer++) {
+            glUniform1f(zUniform, run->z0 + run->step * layer);
+            glDrawArrays(GL_TRIANGLES, 9, 6);
+        }
+        glFinish();
+        double ms = (timeNowMs() - start) / LAYERS;
+        if (repeat == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+static void runTiming(int side, GLuint buffer) {
+    GLuint program = buildProgram("depthMatrixLayers", layerVertexSource, layerFragmentSource);
+    GLuint posAttrib = programAttrib(program, "aPosition");
+    GLint zUniform = programUniform(program, "uZ");
+    stateUseProgram(program);
+    glUniform3f(programUniform(program, "uColor"), 0.2f, 0.5f, 0.7f);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+
+    glViewport(0, 0, side, side);
+    glDisable(GL_SCISSOR_TEST);
+    glDepthRangef(0.0f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    // Compile the function variants before anything is timed
+    for (int i = 0; i < COUNT(timingCases); i++) {
+        glDepthFunc(timingCases[i].func);
+        glDrawArrays(GL_TRIANGLES, 9, 6);
+    }
+    glFinish();
+
+    printf("  %dx%d overdraw, %d layers, ms per layer (relative to ALWAYS):\n", side, side, LAYERS);
+    printf("    %-9s %16s %20s %20s\n", "func", "passing", "rejected, mask on", "rejected, mask off");
+    double always = 0.0;
+    for (int i = 0; i < COUNT(timingCases); i++) {
+        const struct TimingCase *timing = &timingCases[i];
+        char pass[32] = "-", rejectOn[32] = "-", rejectOff[32] = "-";
+
+        if (timing->canPass) {
+            double ms = timeLayers(timing->func, GL_TRUE, &timing->pass, zUniform);
+            if (timing->func == GL_ALWAYS) always = ms;
+            snprintf(pass, sizeof(pass), "%.3f (%.2f)", ms, ms / always);
+        }
+        if (timing->canReject) {
+            double ms = timeLayers(timing->func, GL_TRUE, &timing->reject, zUniform);
+            snprintf(rejectOn, sizeof(rejectOn), "%.3f (%.2f)", ms, ms / always);
+            ms = timeLayers(timing->func, GL_FALSE, &timing->reject, zUniform);
+            snprintf(rejectOff, sizeof(rejectOff), "%.3f (%.2f)", ms, ms / always);
+        }
+        printf("    %-9s %16s %20s %20s\n", funcName(timing->func), pass, rejectOn, rejectOff);
+    }
+    printf("  Rejected layers close to 1.00 were shaded before the depth test (no early-Z).\n");
+
+    stateDisableVertexAttribArray(posAttrib);
+    glDeleteProgram(program);
+}
+
+int runDepthMatrix(int side) {
+    side = platformClampTargetSide(side);
+    side -= side % TILE;
+    if (side <= 0) {
+        return 1;
+    }
+
+    struct DepthTarget target;
+    if (!depthTargetCreate(&target, side, side)) {
+        printf("Depth matrix: no %dx%d depth texture target with highp readback, skipped\n", side, side);
+        glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+        return 0;
+    }
+
+    GLuint program = buildProgram("depthMatrix", vertexSource, fragmentSource);
+    GLuint posAttrib = programAttrib(program, "aPosition");
+    float vertices[15][3];
+    memcpy(vertices, quad, sizeof(quad));
+    memcpy(vertices + 6, crossing, sizeof(crossing));
+    memcpy(vertices + 9, fullQuad, sizeof(fullQuad));
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    size_t pixels = (size_t)side * side;
+    unsigned char *color = malloc(pixels * 4);
+    uint32_t *depth = malloc(pixels * sizeof(uint32_t));
+    float scale = depthRefScale(target.bits);
+    uint32_t tolerance = depthRefTolerance(target.bits);
+
+    int columns = side / TILE, tilesPerBatch = columns * (side / TILE);
+    int tiles[COUNT(funcs)] = {0}, passed[COUNT(funcs)] = {0};
+    int failed = 0, offsetUnitFailed = 0;
+    long compared = 0;
+    double drawMs = 0.0, readMs = 0.0, checkMs = 0.0;
+
+    printf("Depth matrix, %d configurations in %dx%d tiles of a %dx%d %d-bit depth texture, tolerance %u steps\n",
+           CONFIG_COUNT, TILE, TILE, side, side, target.bits, tolerance);
+
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_STENCIL_TEST);
+    float unitSteps = measureOffsetUnit(&target, program, buffer, posAttrib, depth);
+    printf("  polygon offset unit: %.2f steps\n", unitSteps);
+    if (unitSteps < 0.99f) {
+        printf("  FAIL a polygon offset unit must move depth by at least one step\n");
+        offsetUnitFailed = 1;
+    }
+
+    for (int first = 0; first < CONFIG_COUNT; first += tilesPerBatch) {
+        int count = CONFIG_COUNT - first < tilesPerBatch ? CONFIG_COUNT - first : tilesPerBatch;
+
+        double start = timeNowMs();
+        bindMatrixProgram(program, buffer, posAttrib);
+
+        glDisable(GL_SCISSOR_TEST);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glEnable(GL_SCISSOR_TEST);
+        glEnable(GL_DEPTH_TEST);
+        for (int tile = 0; tile < count; tile++) {
+            struct MatrixConfig config = configAt(first + tile);
+            drawTile(&config, (tile % columns) * TILE, (tile / columns) * TILE);
+        }
+        glFinish();
+        double drawn = timeNowMs();
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, side, side, GL_RGBA, GL_UNSIGNED_BYTE, color);
+        depthReadback(&target, 0, 0, side, side, depth);
+        double read = timeNowMs();
+
+        for (int tile = 0; tile < count; tile++) {
+            struct MatrixConfig config = configAt(first + tile);
+            int ok = checkTile(&config, color, depth, side, (tile % columns) * TILE, (tile / columns) * TILE,
+                               scale, tolerance, unitSteps, &compared);
+            tiles[config.func]++;
+            passed[config.func] += ok;
+            if (!ok && failed++ < MAX_REPORTED) {
+                printf("  FAIL %s, clear %g, range [%g, %g], mask %s, offset %s %g/%g\n",
+                       funcName(funcs[config.func]), config.clearDepth, config.range.near, config.range.far,
+                       config.mask ? "on" : "off", config.offset.enabled ? "on" : "off",
+                       config.offset.factor, config.offset.units);
+            }
+        }
+        double checked = timeNowMs();
+
+        drawMs += drawn - start;
+        readMs += read - drawn;
+        checkMs += checked - read;
+    }
+
+    for (int f = 0; f < COUNT(funcs); f++) {
+        printf("  %-9s %d/%d tiles pass\n", funcName(funcs[f]), passed[f], tiles[f]);
+    }
+    printf("  %d/%d configurations match depthRef (%.1f%% of pixels decided); draw %.1f ms, "
+           "readback %.1f ms, check %.1f ms\n", CONFIG_COUNT - failed, CONFIG_COUNT,
+           100.0 * compared / ((double)CONFIG_COUNT * TILE * TILE), drawMs, readMs, checkMs);
+
+    glDisable(GL_SCISSOR_TEST);
+    runTiming(side, buffer);
+
+    free(color);
+    free(depth);
+    stateDisableVertexAttribArray(posAttrib);
+    glDeleteBuffers(1, &buffer);
+    glDeleteProgram(program);
+    depthReadbackRelease();
+
+    glDepthRangef(0.0f, 1.0f);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glClearDepthf(1.0f);
+    glPolygonOffset(0.0f, 0.0f);
+    glDisable(GL_DEPTH_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    depthTargetDelete(&target);
+    stateInvalidate();
+    return failed == 0 && !offsetUnitFailed;
+}
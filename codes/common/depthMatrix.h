@@ -0,0 +1,22 @@
+#ifndef DEPTH_MATRIX_H
+#define DEPTH_MATRIX_H
+
+// The depth test over the state depthFunc.c leaves at its defaults: every
+// depth function x clear depth x glDepthRangef x depth mask x polygon offset,
+// 576 configurations. Each gets a 32x32 tile of a side x side depth texture
+// target, drawn through its own viewport: the tile's depth is cleared, a
+// sloped quad is drawn with GL_ALWAYS and a triangle crossing it with the
+// configuration. A batch reads color and depth back once and checks every
+// tile against depthRef; pixels where the two triangles are too close for
+// interpolation rounding to decide are left out. Prints the tiles passed per
+// function and the failing configurations (the first few).
+//
+// Then times full-target overdraw with an ALU-heavy shader per function,
+// once with layers that pass and once with layers the function rejects
+// (with the depth mask on and off). Rejected layers that cost as much as
+// passing ones were shaded before the test: the driver's early depth test
+// is off for that function. Returns 0 if a tile failed or the target cannot
+// be made.
+int runDepthMatrix(int side);
+
+#endif
@@ -0,0 +1,170 @@
+#include "depthReadback.h"
+#include "glState.h"
+#include "shader.h"
+
+#include <GLES2/gl2ext.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec2 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+    "}";
+
+// Stored values fit in 24 bits, so every step below is exact in highp; only
+// 1.0 * (2^24 - 1) + 0.5 rounds up past the largest value and is clamped. The
+// sampler must be highp too: its default precision is lowp.
+static const char *fragmentSource =
+    "#version 100\n"
+    "precision highp float;\n"
+    "uniform highp sampler2D uDepth;\n"
+    "uniform vec2 uInvSize;\n"
+    "uniform float uScale;\n"
+    "void main() {\n"
+    "    float d = min(floor(texture2D(uDepth, gl_FragCoord.xy * uInvSize).r * uScale + 0.5), uScale);\n"
+    "    float high = floor(d / 65536.0);\n"
+    "    d -= high * 65536.0;\n"
+    "    float middle = floor(d / 256.0);\n"
+    "    gl_FragColor = vec4(d - middle * 256.0, middle, high, 255.0) / 255.0;\n"
+    "}";
+
+static GLuint program;
+static GLuint quad;
+static GLint depthUniform, invSizeUniform, scaleUniform;
+static GLint positionAttrib;
+static unsigned char *packed;
+static size_t packedSize;
+
+int depthTargetCreate(struct DepthTarget *target, int width, int height) {
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    GLint range[2], precision = 0;
+    glGetShaderPrecisionFormat(GL_FRAGMENT_SHADER, GL_HIGH_FLOAT, range, &precision);
+
+    memset(target, 0, sizeof(*target));
+    if (!extensions || !strstr(extensions, "GL_OES_depth_texture") || precision < 23) {
+        return 0;
+    }
+    int packedStencil = strstr(extensions, "GL_OES_packed_depth_stencil") != NULL;
+    target->width = width;
+    target->height = height;
+
+    glGenTextures(1, &target->depth);
+    glBindTexture(GL_TEXTURE_2D, target->depth);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    if (packedStencil) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_STENCIL_OES, width, height, 0,
+                     GL_DEPTH_STENCIL_OES, GL_UNSIGNED_INT_24_8_OES, NULL);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0,
+                     GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &target->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glGenRenderbuffers(1, &target->color);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8_OES, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target->color);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, target->depth, 0);
+    if (packedStencil) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_TEXTURE_2D, target->depth, 0);
+    }
+    int complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glGetIntegerv(GL_DEPTH_BITS, &target->bits);
+
+    glGenFramebuffers(1, &target->packFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->packFramebuffer);
+    glGenRenderbuffers(1, &target->packColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, target->packColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8_OES, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target->packColor);
+    complete &= glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    // Deeper buffers would not survive the trip through a float
+    if (!complete || target->bits <= 0 || target->bits > 24) {
+        depthTargetDelete(target);
+        return 0;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    return 1;
+}
+
+void depthTargetDelete(struct DepthTarget *target) {
+    glDeleteFramebuffers(1, &target->framebuffer);
+    glDeleteFramebuffers(1, &target->packFramebuffer);
+    glDeleteRenderbuffers(1, &target->color);
+    glDeleteRenderbuffers(1, &target->packColor);
+    glDeleteTextures(1, &target->depth);
+    memset(target, 0, sizeof(*target));
+}
+
+void depthReadback(const struct DepthTarget *target, int x, int y, int width, int height, uint32_t *depth) {
+    if (!program) {
+        program = buildProgram("depthReadback", vertexSource, fragmentSource);
+        depthUniform = programUniform(program, "uDepth");
+        invSizeUniform = programUniform(program, "uInvSize");
+        scaleUniform = programUniform(program, "uScale");
+        positionAttrib = programAttrib(program, "aPosition");
+
+        float quadVertices[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+        glGenBuffers(1, &quad);
+        stateBindBuffer(GL_ARRAY_BUFFER, quad);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    }
+
+    size_t size = (size_t)width * height * 4;
+    if (size > packedSize) {
+        packed = realloc(packed, size);
+        packedSize = size;
+    }
+
+    // A texture cannot be sampled while it is attached to the bound framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, target->packFramebuffer);
+    glViewport(0, 0, target->width, target->height);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    stateUseProgram(program);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, target->depth);
+    glUniform1i(depthUniform, 0);
+    glUniform2f(invSizeUniform, 1.0f / target->width, 1.0f / target->height);
+    glUniform1f(scaleUniform, (float)((1u << target->bits) - 1));
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    stateVertexAttribPointer(positionAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(positionAttrib);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, packed);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+
+    size_t pixels = (size_t)width * height;
+    for (size_t i = 0; i < pixels; i++) {
+        const unsigned char *pixel = packed + i * 4;
+        depth[i] = pixel[0] | (uint32_t)pixel[1] << 8 | (uint32_t)pixel[2] << 16;
+    }
+}
+
+void depthReadbackRelease() {
+    if (program) {
+        glDeleteProgram(program);
+        glDeleteBuffers(1, &quad);
+        program = 0;
+        quad = 0;
+    }
+    free(packed);
+    packed = NULL;
+    packedSize = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef DEPTH_READBACK_H
+#define DEPTH_READBACK_H
+
+#include <GLES2/gl2.h>
+#include <stdint.h>
+
+// Reads the depth buffer back, which glReadPixels cannot do in GLES2. The
+// scene is drawn into a target whose depth is a texture (OES_depth_texture);
+// a highp shader samples it, rebuilds the stored integer and splits it into
+// the bytes of an RGBA8 pixel (red the low byte), and one glReadPixels
+// returns every value exactly. The target's stencil comes with the depth
+// texture when OES_packed_depth_stencil is there.
+
+struct DepthTarget {
+    GLuint framebuffer;
+    GLuint color, depth;        // RGBA8 renderbuffer and depth texture
+    GLuint packFramebuffer, packColor;
+    int width, height;
+    int bits;                   // depth bits; values are z * (2^bits - 1)
+};
+
+// Creates the target and leaves it bound. Returns 0 (with the target
+// deleted) without depth textures, highp fragment floats or a complete
+// framebuffer.
+int depthTargetCreate(struct DepthTarget *target, int width, int height);
+void depthTargetDelete(struct DepthTarget *target);
+
+// Fills depth with the stored values of a rectangle of the target, rows
+// bottom to top like glReadPixels. Draws with its own program and buffer
+// and leaves the target bound, the viewport covering it and depth, stencil,
+// scissor, blend and cull off, the color mask all on.
+void depthReadback(const struct DepthTarget *target, int x, int y, int width, int height, uint32_t *depth);
+
+// Deletes the program and buffer made on first use. Call before the context
+// is destroyed.
+void depthReadbackRelease();
+
+#endif
@@ -0,0 +1,162 @@
+#include "depthRef.h"
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+float depthRefScale(int bits) {
+    if (bits > 24) bits = 24;
+    return (float)((1u << bits) - 1);
+}
+
+uint32_t depthRefQuantize(float z, float scale) {
+    z = z < 0.0f ? 0.0f : z > 1.0f ? 1.0f : z;
+    return (uint32_t)lrintf(z * scale);
+}
+
+uint32_t depthRefTolerance(int bits) {
+    return bits > 21 ? 1u << (bits - 21) : 1u;
+}
+
+uint32_t depthRefPlaneSlack(const float plane[3], float x, float y, float scale) {
+    float largest = fabsf(plane[0] * x) + fabsf(plane[1] * y) + fabsf(plane[2]);
+    return (uint32_t)ceilf(largest * scale / (float)(1 << 22));
+}
+
+int depthRefTest(GLenum func, uint32_t z, uint32_t stored) {
+    switch (func) {
+    case GL_NEVER: return 0;
+    case GL_LESS: return z < stored;
+    case GL_LEQUAL: return z <= stored;
+    case GL_GREATER: return z > stored;
+    case GL_GEQUAL: return z >= stored;
+    case GL_EQUAL: return z == stored;
+    case GL_NOTEQUAL: return z != stored;
+    default: return 1;
+    }
+}
+
+// Stored depths fit in 24 bits, so signed 32-bit compares are exact
+#if defined(__AVX2__)
+static __m256i compare256(GLenum func, __m256i z, __m256i stored) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+
+    switch (func) {
+    case GL_NEVER: return _mm256_setzero_si256();
+    case GL_LESS: return _mm256_cmpgt_epi32(stored, z);
+    case GL_LEQUAL: return _mm256_xor_si256(_mm256_cmpgt_epi32(z, stored), ones);
+    case GL_GREATER: return _mm256_cmpgt_epi32(z, stored);
+    case GL_GEQUAL: return _mm256_xor_si256(_mm256_cmpgt_epi32(stored, z), ones);
+    case GL_EQUAL: return _mm256_cmpeq_epi32(z, stored);
+    case GL_NOTEQUAL: return _mm256_xor_si256(_mm256_cmpeq_epi32(z, stored), ones);
+    default: return ones;
+    }
+}
+#endif
+
+#if defined(__SSE2__)
+static __m128i compare128(GLenum func, __m128i z, __m128i stored) {
+    const __m128i ones = _mm_set1_epi32(-1);
+
+    switch (func) {
+    case GL_NEVER: return _mm_setzero_si128();
+    case GL_LESS: return _mm_cmpgt_epi32(stored, z);
+    case GL_LEQUAL: return _mm_xor_si128(_mm_cmpgt_epi32(z, stored), ones);
+    case GL_GREATER: return _mm_cmpgt_epi32(z, stored);
+    case GL_GEQUAL: return _mm_xor_si128(_mm_cmpgt_epi32(stored, z), ones);
+    case GL_EQUAL: return _mm_cmpeq_epi32(z, stored);
+    case GL_NOTEQUAL: return _mm_xor_si128(_mm_cmpeq_epi32(z, stored), ones);
+    default: return ones;
+    }
+}
+#endif
+
+void depthRefSpan(GLenum func, const float plane[3], float scale, int x0, int y,
+                  const uint32_t *depth, uint32_t *z, unsigned char *pass, int count) {
+    float rowBase = plane[1] * (float)y + plane[2];
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256 lanes8 = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 a8 = _mm256_set1_ps(plane[0]), base8 = _mm256_set1_ps(rowBase);
+    const __m256 zero8 = _mm256_setzero_ps(), one8 = _mm256_set1_ps(1.0f), scale8 = _mm256_set1_ps(scale);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_add_ps(_mm256_set1_ps((float)(x0 + i)), lanes8);
+        __m256 zf = _mm256_add_ps(_mm256_mul_ps(a8, x), base8);
+        zf = _mm256_min_ps(_mm256_max_ps(zf, zero8), one8);
+        __m256i zi = _mm256_cvtps_epi32(_mm256_mul_ps(zf, scale8));
+        __m256i passed = compare256(func, zi, _mm256_loadu_si256((const __m256i *)(depth + i)));
+        _mm256_storeu_si256((__m256i *)(z + i), zi);
+
+        // Narrow the 32-bit masks to bytes; packs work within each 128-bit half
+        __m256i bytes = _mm256_packs_epi16(_mm256_packs_epi32(passed, passed), passed);
+        uint32_t low = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+        uint32_t high = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+        memcpy(pass + i, &low, 4);
+        memcpy(pass + i + 4, &high, 4);
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128 lanes4 = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 a4 = _mm_set1_ps(plane[0]), base4 = _mm_set1_ps(rowBase);
+    const __m128 zero4 = _mm_setzero_ps(), one4 = _mm_set1_ps(1.0f), scale4 = _mm_set1_ps(scale);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_add_ps(_mm_set1_ps((float)(x0 + i)), lanes4);
+        __m128 zf = _mm_add_ps(_mm_mul_ps(a4, x), base4);
+        zf = _mm_min_ps(_mm_max_ps(zf, zero4), one4);
+        __m128i zi = _mm_cvtps_epi32(_mm_mul_ps(zf, scale4));
+        __m128i passed = compare128(func, zi, _mm_loadu_si128((const __m128i *)(depth + i)));
+        _mm_storeu_si128((__m128i *)(z + i), zi);
+
+        __m128i bytes = _mm_packs_epi16(_mm_packs_epi32(passed, passed), passed);
+        uint32_t packed = (uint32_t)_mm_cvtsi128_si32(bytes);
+        memcpy(pass + i, &packed, 4);
+    }
+#endif
+
+    for (; i < count; i++) {
+        z[i] = depthRefQuantize(plane[0] * (float)(x0 + i) + rowBase, scale);
+        pass[i] = depthRefTest(func, z[i], depth[i]) ? 0xFF : 0;
+    }
+}
+
+void depthRefStore(uint32_t *depth, const uint32_t *z, const unsigned char *pass, int count) {
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        __m256i mask = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(pass + i)));
+        __m256i old = _mm256_loadu_si256((const __m256i *)(depth + i));
+        __m256i updated = _mm256_blendv_epi8(old, _mm256_loadu_si256((const __m256i *)(z + i)), mask);
+        _mm256_storeu_si256((__m256i *)(depth + i), updated);
+    }
+#endif
+
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        uint32_t packed;
+        memcpy(&packed, pass + i, 4);
+        __m128i bytes = _mm_cvtsi32_si128((int)packed);
+        __m128i mask = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, bytes), _mm_unpacklo_epi8(bytes, bytes));
+        __m128i old = _mm_loadu_si128((const __m128i *)(depth + i));
+        __m128i updated = _mm_or_si128(_mm_and_si128(mask, _mm_loadu_si128((const __m128i *)(z + i))),
+                                       _mm_andnot_si128(mask, old));
+        _mm_storeu_si128((__m128i *)(depth + i), updated);
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (pass[i]) {
+            depth[i] = z[i];
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef DEPTH_REF_H
+#define DEPTH_REF_H
+
+#include <GLES2/gl2.h>
+#include <stdint.h>
+
+// Software model of the GLES2 depth test: all 8 compare functions and the
+// depth write mask, on a depth plane stored as unsigned integers at the
+// precision of the GPU's buffer (z * (2^bits - 1), rounded), so equal depths
+// compare equal exactly as they do on the GPU. Spans interpolate, test and
+// store 8 pixels at a time with AVX2, 4 with SSE2.
+
+// The factor from window z in [0, 1] to stored depth, for a buffer of bits
+// bits (at most 24 are modelled).
+float depthRefScale(int bits);
+uint32_t depthRefQuantize(float z, float scale);
+
+// How many steps a stored GPU value may differ from the model's: GLES2 does
+// not fix how depth is interpolated, and GPUs do it in fp32 in another order
+// than the model, so 2^-21 of the range (8 steps at 24 bits) is allowed.
+uint32_t depthRefTolerance(int bits);
+
+// What evaluating plane in fp32 at pixels up to (x, y) away from the origin
+// may add to that, in steps: about an ulp of its largest term, which grows
+// with the slope and the distance, since the GPU sums the terms in another
+// order than the model.
+uint32_t depthRefPlaneSlack(const float plane[3], float x, float y, float scale);
+
+// Tests count pixels of row y starting at x0 against depth. The fragment
+// depth is plane[0] * x + plane[1] * y + plane[2] (see rasterPlane()), clamped
+// to [0, 1]; it is written to z. pass receives 0xFF where the test passed.
+void depthRefSpan(GLenum func, const float plane[3], float scale, int x0, int y,
+                  const uint32_t *depth, uint32_t *z, unsigned char *pass, int count);
+
+// Stores z where pass is set; skip it when the depth mask is GL_FALSE.
+void depthRefStore(uint32_t *depth, const uint32_t *z, const unsigned char *pass, int count);
+
+// Whether the depth test passes for one fragment; the scalar definition the
+// span kernel is checked against.
+int depthRefTest(GLenum func, uint32_t z, uint32_t stored);
+
+#endif
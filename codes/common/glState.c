@@ -0,0 +1,154 @@
+#include "glState.h"
+
+#define MAX_ATTRIBS 16
+
+struct AttribState {
+    int pointerKnown;
+    GLuint buffer;          // GL_ARRAY_BUFFER binding captured by the pointer call
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLsizei stride;
+    const void *pointer;
+    int enabledKnown;
+    int enabled;
+};
+
+static int programKnown;
+static GLuint currentProgram;
+static int arrayBufferKnown, elementBufferKnown;
+static GLuint arrayBuffer, elementBuffer;
+static struct AttribState attribs[MAX_ATTRIBS];
+
+static struct StateCounters counters;
+
+static int issue(int redundant) {
+    if (redundant) {
+        counters.elided++;
+        return 0;
+    }
+    counters.issued++;
+    return 1;
+}
+
+void stateUseProgram(GLuint program) {
+    if (issue(programKnown && currentProgram == program)) {
+        glUseProgram(program);
+        programKnown = 1;
+        currentProgram = program;
+    }
+}
+
+void stateBindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (issue(arrayBufferKnown && arrayBuffer == buffer)) {
+            glBindBuffer(target, buffer);
+            arrayBufferKnown = 1;
+            arrayBuffer = buffer;
+        }
+    } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        if (issue(elementBufferKnown && elementBuffer == buffer)) {
+            glBindBuffer(target, buffer);
+            elementBufferKnown = 1;
+            elementBuffer = buffer;
+        }
+    } else {
+        counters.issued++;
+        glBindBuffer(target, buffer);
+    }
+}
+
+static GLsizei typeSize(GLenum type) {
+    switch (type) {
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE: return 1;
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT: return 2;
+    default: return 4;
+    }
+}
+
+void stateVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                              GLsizei stride, const void *pointer) {
+    if (index >= MAX_ATTRIBS || !arrayBufferKnown) {
+        counters.issued++;
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+        if (index < MAX_ATTRIBS) attribs[index].pointerKnown = 0;
+        return;
+    }
+
+    // A stride of 0 means tightly packed, so compare the effective stride
+    if (stride == 0) {
+        stride = size * typeSize(type);
+    }
+
+    struct AttribState *a = &attribs[index];
+    int redundant = a->pointerKnown && a->buffer == arrayBuffer && a->size == size && a->type == type &&
+                    a->normalized == normalized && a->stride == stride && a->pointer == pointer;
+
+    if (issue(redundant)) {
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+        a->pointerKnown = 1;
+        a->buffer = arrayBuffer;
+        a->size = size;
+        a->type = type;
+        a->normalized = normalized;
+        a->stride = stride;
+        a->pointer = pointer;
+    }
+}
+
+void stateEnableVertexAttribArray(GLuint index) {
+    if (index >= MAX_ATTRIBS) {
+        counters.issued++;
+        glEnableVertexAttribArray(index);
+    } else if (issue(attribs[index].enabledKnown && attribs[index].enabled)) {
+        glEnableVertexAttribArray(index);
+        attribs[index].enabledKnown = 1;
+        attribs[index].enabled = 1;
+    }
+}
+
+void stateDisableVertexAttribArray(GLuint index) {
+    if (index >= MAX_ATTRIBS) {
+        counters.issued++;
+        glDisableVertexAttribArray(index);
+    } else if (issue(attribs[index].enabledKnown && !attribs[index].enabled)) {
+        glDisableVertexAttribArray(index);
+        attribs[index].enabledKnown = 1;
+        attribs[index].enabled = 0;
+    }
+}
+
+int stateAttribSource(GLuint index, GLuint *buffer, GLint *size, GLenum *type,
+                      GLsizei *stride, const void **pointer) {
+    if (index >= MAX_ATTRIBS || !attribs[index].pointerKnown) {
+        return 0;
+    }
+
+    *buffer = attribs[index].buffer;
+    *size = attribs[index].size;
+    *type = attribs[index].type;
+    *stride = attribs[index].stride;
+    *pointer = attribs[index].pointer;
+    return 1;
+}
+
+void stateInvalidate() {
+    programKnown = 0;
+    arrayBufferKnown = 0;
+    elementBufferKnown = 0;
+    for (int i = 0; i < MAX_ATTRIBS; i++) {
+        attribs[i].pointerKnown = 0;
+        attribs[i].enabledKnown = 0;
+    }
+}
+
+struct StateCounters stateCounters() {
+    return counters;
+}
+
+void stateResetCounters() {
+    counters.issued = 0;
+    counters.elided = 0;
+}
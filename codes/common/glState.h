@@ -0,0 +1,35 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GLES2/gl2.h>
+
+// Shadowed versions of the binding calls the draw loops repeat. A call that
+// would not change the bound state is dropped before it reaches the driver.
+// Code that changes this state behind the wrappers' back (raw GL calls,
+// deleting a bound object) must call stateInvalidate() afterwards.
+void stateUseProgram(GLuint program);
+void stateBindBuffer(GLenum target, GLuint buffer);
+void stateVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                              GLsizei stride, const void *pointer);
+void stateEnableVertexAttribArray(GLuint index);
+void stateDisableVertexAttribArray(GLuint index);
+
+// Forgets the shadowed state, so the next call of each kind is always issued.
+void stateInvalidate();
+
+// Where an attribute reads its vertices from, as last set through
+// stateVertexAttribPointer(): the buffer bound at that call and the effective
+// stride. Returns 0 if the shadow does not know.
+int stateAttribSource(GLuint index, GLuint *buffer, GLint *size, GLenum *type,
+                      GLsizei *stride, const void **pointer);
+
+struct StateCounters {
+    long issued;
+    long elided;
+};
+
+// Calls issued and elided since the last stateResetCounters().
+struct StateCounters stateCounters();
+void stateResetCounters();
+
+#endif
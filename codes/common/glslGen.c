@@ -0,0 +1,27 @@
+#include "glslGen.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+char *formatSource(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    char *source = malloc(length + 1);
+    va_start(args, format);
+    vsnprintf(source, length + 1, format, args);
+    va_end(args);
+    return source;
+}
+
+const char *glslFloat(char buffer[32], float value) {
+    snprintf(buffer, 32, "%.9g", value);
+    if (!strpbrk(buffer, ".eE")) {
+        strcat(buffer, ".0");
+    }
+    return buffer;
+}
@@ -0,0 +1,15 @@
+#ifndef GLSL_GEN_H
+#define GLSL_GEN_H
+
+// Helpers for suites that generate their shaders from tables.
+
+// printf into a freshly malloc'd string. buildProgram() keeps pointers to the
+// sources it was given, so generated shaders must stay alive for the whole run.
+char *formatSource(const char *format, ...);
+
+// Writes value as a GLSL ES float literal: GLSL ES 1.00 has no implicit int to
+// float conversion, so "2" becomes "2.0". The printed value converts back to
+// exactly the same float.
+const char *glslFloat(char buffer[32], float value);
+
+#endif
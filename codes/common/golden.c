@@ -0,0 +1,167 @@
+#include "golden.h"
+#include "imageCompare.h"
+#include "suite.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *goldenDir = NULL;
+static const char *heatmapDir = NULL;
+static int tolerance = 8;
+static double maxMismatchPercent = 1.0;
+
+// State of the suite being checked
+static const struct Suite *current;
+static struct Image reference;
+static int offsetX, offsetY, located;
+static int frameWidth, frameHeight;
+static unsigned char *frame, *frameErrors, *worstErrors;
+static int framesChecked, framesFailed;
+static long worstMismatched;
+static int worstError;
+
+int goldenParseArg(const char *arg, const char *value) {
+    if (!value) {
+        return 0;
+    }
+
+    if (strcmp(arg, "--golden") == 0) {
+        goldenDir = value;
+    } else if (strcmp(arg, "--heatmap") == 0) {
+        heatmapDir = value;
+    } else if (strcmp(arg, "--tolerance") == 0) {
+        tolerance = atoi(value);
+    } else if (strcmp(arg, "--max-mismatch") == 0) {
+        maxMismatchPercent = atof(value);
+    } else {
+        return 0;
+    }
+    return 2;
+}
+
+int goldenEnabled() {
+    return goldenDir != NULL;
+}
+
+void goldenBegin(const struct Suite *suite) {
+    current = suite;
+    located = 0;
+    framesChecked = framesFailed = 0;
+    worstMismatched = 0;
+    worstError = 0;
+
+    if (!goldenDir) {
+        return;
+    }
+
+    // The reference is decoded once per suite, not per frame
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", goldenDir, suite->reference);
+    if (!pngRead(path, &reference)) {
+        return;
+    }
+
+    platformGetFramebufferSize(&frameWidth, &frameHeight);
+    size_t pixels = (size_t)frameWidth * frameHeight;
+    frame = malloc(pixels * 4);
+    frameErrors = malloc(pixels);
+    worstErrors = calloc(pixels, 1);
+}
+
+void goldenCheckFrame() {
+    if (!goldenDir || !reference.pixels) {
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, frameWidth, frameHeight, GL_RGBA, GL_UNSIGNED_BYTE, frame);
+
+    if (!located) {
+        if (!findFrameOffset(&reference, frame, frameWidth, frameHeight, &offsetX, &offsetY)) {
+            printf("%s: reference %dx%d is smaller than the %dx%d frame\n", current->name,
+                   reference.width, reference.height, frameWidth, frameHeight);
+            imageFree(&reference);
+            return;
+        }
+        located = 1;
+    }
+
+    struct CompareResult result;
+    compareFrame(&reference, offsetX, offsetY, frame, frameWidth, frameHeight, tolerance,
+                 heatmapDir ? frameErrors : NULL, &result);
+
+    framesChecked++;
+    if (result.mismatched * 100.0 > maxMismatchPercent * frameWidth * frameHeight) {
+        framesFailed++;
+    }
+    if (result.mismatched > worstMismatched) worstMismatched = result.mismatched;
+    if (result.maxError > worstError) worstError = result.maxError;
+
+    if (heatmapDir) {
+        size_t pixels = (size_t)frameWidth * frameHeight;
+        for (size_t i = 0; i < pixels; i++) {
+            if (frameErrors[i] > worstErrors[i]) worstErrors[i] = frameErrors[i];
+        }
+    }
+}
+
+// Mismatches in red, scaled by error; matching pixels show a faded reference.
+static void writeHeatmap() {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.heatmap.png", heatmapDir, current->name);
+
+    size_t pixels = (size_t)frameWidth * frameHeight;
+    unsigned char *rgba = malloc(pixels * 4);
+
+    for (int y = 0; y < frameHeight; y++) {
+        const unsigned char *ref = reference.pixels + ((size_t)(offsetY + y) * reference.width + offsetX) * 4;
+        for (int x = 0; x < frameWidth; x++) {
+            size_t i = (size_t)y * frameWidth + x;
+            int error = worstErrors[i];
+            unsigned char *out = rgba + i * 4;
+
+            if (error > tolerance) {
+                out[0] = 128 + error / 2;
+                out[1] = 0;
+                out[2] = 0;
+            } else {
+                int gray = (ref[x * 4] + ref[x * 4 + 1] + ref[x * 4 + 2]) / 12;
+                out[0] = out[1] = out[2] = gray;
+            }
+            out[3] = 255;
+        }
+    }
+
+    if (pngWrite(path, frameWidth, frameHeight, rgba)) {
+        printf("  heatmap: %s\n", path);
+    }
+    free(rgba);
+}
+
+int goldenEnd() {
+    int passed = 1;
+
+    if (goldenDir) {
+        if (!reference.pixels || framesChecked == 0) {
+            printf("%s: golden FAIL (no reference compared)\n", current->name);
+            passed = 0;
+        } else {
+            passed = framesFailed == 0;
+            printf("%s: golden %s, %d/%d frames failed, worst %ld mismatched pixels (%.2f%%), max error %d, offset %d,%d\n",
+                   current->name, passed ? "PASS" : "FAIL", framesFailed, framesChecked, worstMismatched,
+                   worstMismatched * 100.0 / ((double)frameWidth * frameHeight), worstError, offsetX, offsetY);
+            if (heatmapDir) {
+                writeHeatmap();
+            }
+        }
+    }
+
+    imageFree(&reference);
+    free(frame);
+    free(frameErrors);
+    free(worstErrors);
+    frame = frameErrors = worstErrors = NULL;
+    return passed;
+}
@@ -0,0 +1,22 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+struct Suite;
+
+// Golden-image checks against the screenshots checked in next to each suite.
+//   --golden DIR        compare every drawn frame; DIR is the codes/ directory
+//   --tolerance N       allowed difference per channel (default 8)
+//   --max-mismatch PCT  mismatched pixels allowed per frame (default 1%)
+//   --heatmap DIR       write <suite>.heatmap.png with the worst error per pixel
+
+// Returns how many arguments it consumed (0 if arg is not a golden flag).
+int goldenParseArg(const char *arg, const char *value);
+int goldenEnabled();
+
+void goldenBegin(const struct Suite *suite);
+void goldenCheckFrame();
+
+// Prints the summary and returns 1 if every frame matched.
+int goldenEnd();
+
+#endif
@@ -0,0 +1,229 @@
+#include "imageCompare.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static int pixelError(const unsigned char *a, const unsigned char *b) {
+    int error = 0;
+    for (int c = 0; c < 3; c++) {
+        int d = abs(a[c] - b[c]);
+        if (d > error) error = d;
+    }
+    return error;
+}
+
+// Compares count pixels, writes per-pixel errors and returns the mismatch count.
+static long compareRow(const unsigned char *ref, const unsigned char *frame, int count,
+                       int tolerance, unsigned char *errors, int *maxError) {
+    long mismatched = 0;
+    int rowMax = 0;
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i rgbMask8 = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i lowByte8 = _mm256_set1_epi32(0xFF);
+    const __m256i tolerance8 = _mm256_set1_epi32(tolerance);
+    __m256i max8 = _mm256_setzero_si256();
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(ref + i * 4));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(frame + i * 4));
+        __m256i d = _mm256_and_si256(_mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a)), rgbMask8);
+
+        // Largest of R, G, B lands in the low byte of each pixel
+        __m256i m = _mm256_max_epu8(d, _mm256_srli_epi32(d, 8));
+        m = _mm256_and_si256(_mm256_max_epu8(m, _mm256_srli_epi32(d, 16)), lowByte8);
+
+        __m256i bad = _mm256_cmpgt_epi32(m, tolerance8);
+        mismatched += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(bad)));
+        max8 = _mm256_max_epu8(max8, m);
+
+        if (errors) {
+            __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(m, m), _mm256_setzero_si256());
+            int low = _mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+            int high = _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+            memcpy(errors + i, &low, 4);
+            memcpy(errors + i + 4, &high, 4);
+        }
+    }
+
+    unsigned char lanes8[32];
+    _mm256_storeu_si256((__m256i *)lanes8, max8);
+    for (int k = 0; k < 32; k += 4) {
+        if (lanes8[k] > rowMax) rowMax = lanes8[k];
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i lowByte = _mm_set1_epi32(0xFF);
+    const __m128i tolerance4 = _mm_set1_epi32(tolerance);
+    __m128i max4 = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(ref + i * 4));
+        __m128i b = _mm_loadu_si128((const __m128i *)(frame + i * 4));
+        __m128i d = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a)), rgbMask);
+
+        __m128i m = _mm_max_epu8(d, _mm_srli_epi32(d, 8));
+        m = _mm_and_si128(_mm_max_epu8(m, _mm_srli_epi32(d, 16)), lowByte);
+
+        __m128i bad = _mm_cmpgt_epi32(m, tolerance4);
+        mismatched += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(bad)));
+        max4 = _mm_max_epu8(max4, m);
+
+        if (errors) {
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(m, m), _mm_setzero_si128());
+            int value = _mm_cvtsi128_si32(packed);
+            memcpy(errors + i, &value, 4);
+        }
+    }
+
+    unsigned char lanes4[16];
+    _mm_storeu_si128((__m128i *)lanes4, max4);
+    for (int k = 0; k < 16; k += 4) {
+        if (lanes4[k] > rowMax) rowMax = lanes4[k];
+    }
+#endif
+
+    for (; i < count; i++) {
+        int error = pixelError(ref + i * 4, frame + i * 4);
+        if (error > tolerance) mismatched++;
+        if (error > rowMax) rowMax = error;
+        if (errors) errors[i] = error;
+    }
+
+    if (rowMax > *maxError) {
+        *maxError = rowMax;
+    }
+    return mismatched;
+}
+
+// Sparse scoring ties on flat images: offsets a few pixels apart see the same
+// samples. The best few placements are re-scored on every pixel, along with
+// every placement up to one sample step around them.
+#define CANDIDATES 4
+#define DENSE_TOLERANCE 16
+
+struct Placement {
+    int x, y;
+    long score;
+};
+
+static long denseScore(const struct Image *reference, const unsigned char *frame,
+                       int width, int height, int dx, int dy, long best) {
+    long score = 0;
+    int maxError = 0;
+
+    // Rows in an interleaved order, so a poor placement passes best within a few
+    for (int phase = 0; phase < 8; phase++) {
+        for (int y = phase; y < height && (best < 0 || score < best); y += 8) {
+            const unsigned char *refRow = reference->pixels + ((size_t)(dy + y) * reference->width + dx) * 4;
+            const unsigned char *frameRow = frame + (size_t)(height - 1 - y) * width * 4;
+            score += compareRow(refRow, frameRow, width, DENSE_TOLERANCE, NULL, &maxError);
+        }
+    }
+    return score;
+}
+
+int findFrameOffset(const struct Image *reference, const unsigned char *frame,
+                    int width, int height, int *offsetX, int *offsetY) {
+    if (reference->width < width || reference->height < height) {
+        return 0;
+    }
+
+    // Score every placement on a sparse grid of sample points, keeping the best few
+    int stepX = width / 64 > 0 ? width / 64 : 1;
+    int stepY = height / 64 > 0 ? height / 64 : 1;
+    struct Placement candidates[CANDIDATES];
+    int count = 0;
+
+    for (int dy = 0; dy <= reference->height - height; dy++) {
+        for (int dx = 0; dx <= reference->width - width; dx++) {
+            long worst = count == CANDIDATES ? candidates[count - 1].score : -1;
+            long score = 0;
+
+            for (int y = stepY / 2; y < height && (worst < 0 || score < worst); y += stepY) {
+                const unsigned char *refRow = reference->pixels + ((size_t)(dy + y) * reference->width + dx) * 4;
+                const unsigned char *frameRow = frame + (size_t)(height - 1 - y) * width * 4;
+
+                for (int x = stepX / 2; x < width; x += stepX) {
+                    int error = pixelError(refRow + x * 4, frameRow + x * 4);
+                    score += error < 64 ? error : 64;
+                }
+            }
+
+            if (worst >= 0 && score >= worst) {
+                continue;
+            }
+            int at = count < CANDIDATES ? count++ : CANDIDATES - 1;
+            while (at > 0 && candidates[at - 1].score > score) {
+                candidates[at] = candidates[at - 1];
+                at--;
+            }
+            candidates[at] = (struct Placement){dx, dy, score};
+        }
+    }
+
+    int columns = reference->width - width + 1, rows = reference->height - height + 1;
+    unsigned char *visited = calloc((size_t)columns * rows, 1);
+    long best = -1;
+
+    // The candidates themselves first, so the window search exits rows early
+    for (int c = 0; c < count; c++) {
+        visited[(size_t)candidates[c].y * columns + candidates[c].x] = 1;
+        long score = denseScore(reference, frame, width, height, candidates[c].x, candidates[c].y, best);
+        if (best < 0 || score < best) {
+            best = score;
+            *offsetX = candidates[c].x;
+            *offsetY = candidates[c].y;
+        }
+    }
+
+    for (int c = 0; c < count; c++) {
+        int x0 = candidates[c].x - stepX > 0 ? candidates[c].x - stepX : 0;
+        int y0 = candidates[c].y - stepY > 0 ? candidates[c].y - stepY : 0;
+        int x1 = candidates[c].x + stepX < columns - 1 ? candidates[c].x + stepX : columns - 1;
+        int y1 = candidates[c].y + stepY < rows - 1 ? candidates[c].y + stepY : rows - 1;
+
+        for (int dy = y0; dy <= y1; dy++) {
+            for (int dx = x0; dx <= x1; dx++) {
+                if (visited[(size_t)dy * columns + dx]) {
+                    continue;
+                }
+                visited[(size_t)dy * columns + dx] = 1;
+
+                long score = denseScore(reference, frame, width, height, dx, dy, best);
+                if (best < 0 || score < best) {
+                    best = score;
+                    *offsetX = dx;
+                    *offsetY = dy;
+                }
+            }
+        }
+    }
+    free(visited);
+    return 1;
+}
+
+void compareFrame(const struct Image *reference, int offsetX, int offsetY,
+                  const unsigned char *frame, int width, int height, int tolerance,
+                  unsigned char *errorMap, struct CompareResult *result) {
+    result->mismatched = 0;
+    result->maxError = 0;
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char *refRow = reference->pixels + ((size_t)(offsetY + y) * reference->width + offsetX) * 4;
+        const unsigned char *frameRow = frame + (size_t)(height - 1 - y) * width * 4;
+        unsigned char *errorRow = errorMap ? errorMap + (size_t)y * width : NULL;
+
+        result->mismatched += compareRow(refRow, frameRow, width, tolerance, errorRow, &result->maxError);
+    }
+}
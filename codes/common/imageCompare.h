@@ -0,0 +1,24 @@
+#ifndef IMAGE_COMPARE_H
+#define IMAGE_COMPARE_H
+
+#include "png.h"
+
+struct CompareResult {
+    long mismatched;    // pixels with an RGB channel off by more than the tolerance
+    int maxError;       // largest channel difference over the whole frame
+};
+
+// The checked-in screenshots include the window decorations, so the frame is
+// located inside the reference once before comparing. frame is glReadPixels
+// output: RGBA, rows bottom to top. Returns 0 if the reference is too small.
+int findFrameOffset(const struct Image *reference, const unsigned char *frame,
+                    int width, int height, int *offsetX, int *offsetY);
+
+// Per-channel tolerance compare of the RGB channels (alpha is ignored).
+// errorMap, if not NULL, receives width * height per-pixel maximum channel
+// errors with rows top to bottom.
+void compareFrame(const struct Image *reference, int offsetX, int offsetY,
+                  const unsigned char *frame, int width, int height, int tolerance,
+                  unsigned char *errorMap, struct CompareResult *result);
+
+#endif
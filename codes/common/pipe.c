@@ -0,0 +1,673 @@
+#include "pipe.h"
+#include "depthRef.h"
+#include "glState.h"
+#include "imageCompare.h"
+#include "platform.h"
+#include "png.h"
+#include "raster.h"
+#include "stencilReadback.h"
+#include "stencilRef.h"
+#include "suite.h"
+#include "timing.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_BUFFERS 64
+
+// The model must match the GPU exactly: one step of rounding per channel is
+// all that is allowed.
+#define REFERENCE_TOLERANCE 1
+
+static int enabled;
+static const char *dumpDir;
+
+// CPU copies of the buffers uploaded through pipeBufferData()
+struct BufferCopy {
+    GLuint buffer;
+    GLsizeiptr size;
+    unsigned char *data;
+};
+
+static struct BufferCopy buffers[MAX_BUFFERS];
+static int bufferCount;
+
+// Model state, mirroring the GL state the pipe* calls set
+static int viewport[4];
+static unsigned char clearColor[4];
+static unsigned char clearStencil;
+static int stencilTest;
+static struct StencilFace faces[2];    // front, back
+static unsigned char color[4];
+static int depthTest;
+static GLenum depthFunc;
+static int depthMask;
+static float clearDepth;
+static float depthRange[2];
+static float depthScale;              // 0 without a depth buffer
+
+// Model framebuffer: RGBA color, stencil and depth, rows top to bottom like struct Image
+static struct Image model;
+static unsigned char *stencil;
+static uint32_t *depth;
+static unsigned char *passMask;
+static unsigned char *depthPassMask;
+static uint32_t *spanZ;
+static unsigned char *frame;
+
+// State of the suite being checked
+static const struct Suite *current;
+static int touched;                   // this frame drew through the pipe
+static int followed;                  // and the model followed every draw
+static unsigned unmodelledCaps;       // capBit() of every enabled cap the model ignores
+static int framesChecked, framesFailed, framesSkipped;
+static long worstMismatched;
+static int worstError;
+static double modelMs;
+static int stencilFramesChecked;
+static long worstStencilMismatched;
+static double readbackMs;
+
+int pipeParseArg(const char *arg, const char *value) {
+    if (strcmp(arg, "--reference") == 0) {
+        enabled = 1;
+        return 1;
+    }
+    if (strcmp(arg, "--reference-dump") == 0 && value) {
+        enabled = 1;
+        dumpDir = value;
+        return 2;
+    }
+    return 0;
+}
+
+static unsigned char toUnorm8(float value) {
+    if (value <= 0.0f) return 0;
+    if (value >= 1.0f) return 255;
+    return (unsigned char)lrintf(value * 255.0f);
+}
+
+// A plain store loop the compiler turns into vector stores; the model's
+// planes come from malloc and carry no declared type
+static void fill32(void *dst, uint32_t value, size_t count) {
+    uint32_t *out = dst;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = value;
+    }
+}
+
+// Keeps the model the size of the framebuffer; a resize clears it like a new surface
+static void resizeModel() {
+    int width, height;
+    platformGetFramebufferSize(&width, &height);
+    if (width == model.width && height == model.height) {
+        return;
+    }
+
+    size_t pixels = (size_t)width * height;
+    model.width = width;
+    model.height = height;
+    model.pixels = realloc(model.pixels, pixels * 4);
+    stencil = realloc(stencil, pixels);
+    depth = realloc(depth, pixels * sizeof(uint32_t));
+    passMask = realloc(passMask, width);
+    depthPassMask = realloc(depthPassMask, width);
+    spanZ = realloc(spanZ, width * sizeof(uint32_t));
+    frame = realloc(frame, pixels * 4);
+    memset(model.pixels, 0, pixels * 4);
+    memset(stencil, 0, pixels);
+    memset(depth, 0, pixels * sizeof(uint32_t));
+}
+
+void pipeBegin(const struct Suite *suite) {
+    current = suite;
+    framesChecked = framesFailed = framesSkipped = 0;
+    worstMismatched = 0;
+    worstError = 0;
+    modelMs = 0.0;
+    stencilFramesChecked = 0;
+    worstStencilMismatched = 0;
+    readbackMs = 0.0;
+    touched = 0;
+    followed = 1;
+    unmodelledCaps = 0;
+
+    viewport[0] = viewport[1] = 0;
+    platformGetFramebufferSize(&viewport[2], &viewport[3]);
+    memset(clearColor, 0, sizeof(clearColor));
+    clearStencil = 0;
+    stencilTest = 0;
+    stencilFaceDefaults(&faces[0]);
+    stencilFaceDefaults(&faces[1]);
+    color[0] = color[1] = color[2] = color[3] = 255;
+    depthTest = 0;
+    depthFunc = GL_LESS;
+    depthMask = 1;
+    clearDepth = 1.0f;
+    depthRange[0] = 0.0f;
+    depthRange[1] = 1.0f;
+
+    if (enabled) {
+        GLint bits = 0;
+        glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+        glGetIntegerv(GL_DEPTH_BITS, &bits);
+        depthScale = bits > 0 ? depthRefScale(bits) : 0.0f;
+        resizeModel();
+    }
+}
+
+void pipeClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    glClearColor(red, green, blue, alpha);
+    clearColor[0] = toUnorm8(red);
+    clearColor[1] = toUnorm8(green);
+    clearColor[2] = toUnorm8(blue);
+    clearColor[3] = toUnorm8(alpha);
+}
+
+void pipeClearStencil(GLint s) {
+    glClearStencil(s);
+    clearStencil = (unsigned char)s;
+}
+
+void pipeClear(GLbitfield mask) {
+    glClear(mask);
+    if (!enabled) {
+        return;
+    }
+
+    double start = timeNowMs();
+    touched = 1;
+    resizeModel();
+    size_t pixels = (size_t)model.width * model.height;
+
+    if (mask & GL_COLOR_BUFFER_BIT) {
+        uint32_t value;
+        memcpy(&value, clearColor, 4);
+        fill32(model.pixels, value, pixels);
+    }
+
+    // Clears go through the front stencil write mask
+    if (mask & GL_STENCIL_BUFFER_BIT) {
+        unsigned char writeMask = (unsigned char)faces[0].writeMask;
+        if (writeMask == 0xFF) {
+            memset(stencil, clearStencil, pixels);
+        } else {
+            for (size_t i = 0; i < pixels; i++) {
+                stencil[i] = (stencil[i] & ~writeMask) | (clearStencil & writeMask);
+            }
+        }
+    }
+
+    if ((mask & GL_DEPTH_BUFFER_BIT) && depthMask) {
+        fill32(depth, depthRefQuantize(clearDepth, depthScale), pixels);
+    }
+    modelMs += timeNowMs() - start;
+}
+
+void pipeClearDepthf(GLfloat d) {
+    glClearDepthf(d);
+    clearDepth = d;
+}
+
+void pipeDepthFunc(GLenum func) {
+    glDepthFunc(func);
+    depthFunc = func;
+}
+
+void pipeDepthMask(GLboolean flag) {
+    glDepthMask(flag);
+    depthMask = flag != GL_FALSE;
+}
+
+void pipeDepthRangef(GLfloat n, GLfloat f) {
+    glDepthRangef(n, f);
+    depthRange[0] = n < 0.0f ? 0.0f : n > 1.0f ? 1.0f : n;
+    depthRange[1] = f < 0.0f ? 0.0f : f > 1.0f ? 1.0f : f;
+}
+
+void pipeViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    glViewport(x, y, width, height);
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+}
+
+// One bit per capability the model ignores. Unknown caps share the last bit,
+// which pipeDisable() never clears since it cannot tell them apart.
+#define CAP_OTHER (1u << 7)
+
+static unsigned capBit(GLenum cap) {
+    switch (cap) {
+    case GL_BLEND: return 1u << 0;
+    case GL_CULL_FACE: return 1u << 1;
+    case GL_DITHER: return 1u << 2;
+    case GL_POLYGON_OFFSET_FILL: return 1u << 3;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE: return 1u << 4;
+    case GL_SAMPLE_COVERAGE: return 1u << 5;
+    case GL_SCISSOR_TEST: return 1u << 6;
+    default: return CAP_OTHER;
+    }
+}
+
+void pipeEnable(GLenum cap) {
+    glEnable(cap);
+    if (cap == GL_STENCIL_TEST) {
+        stencilTest = 1;
+    } else if (cap == GL_DEPTH_TEST) {
+        depthTest = 1;
+    } else {
+        // Any other capability changes the output in ways the model ignores
+        // until it is disabled again
+        unmodelledCaps |= capBit(cap);
+    }
+}
+
+void pipeDisable(GLenum cap) {
+    glDisable(cap);
+    if (cap == GL_STENCIL_TEST) {
+        stencilTest = 0;
+    } else if (cap == GL_DEPTH_TEST) {
+        depthTest = 0;
+    } else if (capBit(cap) != CAP_OTHER) {
+        unmodelledCaps &= ~capBit(cap);
+    }
+}
+
+// faces[0] is the front face, faces[1] the back face
+static int appliesTo(GLenum face, int index) {
+    return face == GL_FRONT_AND_BACK || face == (index == 0 ? GL_FRONT : GL_BACK);
+}
+
+static void setFunc(GLenum face, GLenum func, GLint ref, GLuint mask) {
+    for (int i = 0; i < 2; i++) {
+        if (appliesTo(face, i)) {
+            faces[i].func = func;
+            faces[i].ref = ref;
+            faces[i].valueMask = mask;
+        }
+    }
+}
+
+static void setOp(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {
+    for (int i = 0; i < 2; i++) {
+        if (appliesTo(face, i)) {
+            faces[i].sfail = sfail;
+            faces[i].dpfail = dpfail;
+            faces[i].dppass = dppass;
+        }
+    }
+}
+
+static void setMask(GLenum face, GLuint mask) {
+    for (int i = 0; i < 2; i++) {
+        if (appliesTo(face, i)) {
+            faces[i].writeMask = mask;
+        }
+    }
+}
+
+void pipeStencilFunc(GLenum func, GLint ref, GLuint mask) {
+    glStencilFunc(func, ref, mask);
+    setFunc(GL_FRONT_AND_BACK, func, ref, mask);
+}
+
+void pipeStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) {
+    glStencilFuncSeparate(face, func, ref, mask);
+    setFunc(face, func, ref, mask);
+}
+
+void pipeStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+    glStencilOp(sfail, dpfail, dppass);
+    setOp(GL_FRONT_AND_BACK, sfail, dpfail, dppass);
+}
+
+void pipeStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {
+    glStencilOpSeparate(face, sfail, dpfail, dppass);
+    setOp(face, sfail, dpfail, dppass);
+}
+
+void pipeStencilMask(GLuint mask) {
+    glStencilMask(mask);
+    setMask(GL_FRONT_AND_BACK, mask);
+}
+
+void pipeStencilMaskSeparate(GLenum face, GLuint mask) {
+    glStencilMaskSeparate(face, mask);
+    setMask(face, mask);
+}
+
+void pipeBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    glBufferData(target, size, data, usage);
+    if (!enabled || target != GL_ARRAY_BUFFER) {
+        return;
+    }
+
+    GLint bound = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &bound);
+
+    struct BufferCopy *copy = NULL;
+    for (int i = 0; i < bufferCount; i++) {
+        if (buffers[i].buffer == (GLuint)bound) copy = &buffers[i];
+    }
+    if (!copy && bufferCount < MAX_BUFFERS) {
+        copy = &buffers[bufferCount++];
+        copy->data = NULL;
+    }
+    if (!copy) {
+        return;
+    }
+
+    copy->buffer = bound;
+    copy->size = data ? size : 0;
+    copy->data = realloc(copy->data, size > 0 ? size : 1);
+    if (data) {
+        memcpy(copy->data, data, size);
+    }
+}
+
+void pipeUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) {
+    glUniform3f(location, x, y, z);
+    color[0] = toUnorm8(x);
+    color[1] = toUnorm8(y);
+    color[2] = toUnorm8(z);
+    color[3] = 255;
+}
+
+void pipeUniform3fv(GLint location, GLsizei count, const GLfloat *value) {
+    glUniform3fv(location, count, value);
+    color[0] = toUnorm8(value[0]);
+    color[1] = toUnorm8(value[1]);
+    color[2] = toUnorm8(value[2]);
+    color[3] = 255;
+}
+
+struct SpanContext {
+    const struct StencilFace *face;    // NULL with the stencil test off
+    const float *plane;                // window z, NULL with the depth test off
+};
+
+// The fragment stages in GL order: depth test, stencil test and update, then
+// the depth and color writes of the fragments that passed both
+static void shadeSpan(void *context, int y, int x0, int x1) {
+    const struct SpanContext *span = context;
+    size_t row = (size_t)(model.height - 1 - y) * model.width;
+    unsigned char *pixels = model.pixels + (row + x0) * 4;
+    int count = x1 - x0;
+    uint32_t value;
+    memcpy(&value, color, 4);
+
+    const unsigned char *depthPass = NULL;
+    if (span->plane) {
+        depthRefSpan(depthFunc, span->plane, depthScale, x0, y, depth + row + x0, spanZ, depthPassMask, count);
+        depthPass = depthPassMask;
+    }
+
+    const unsigned char *pass = depthPass;
+    if (span->face) {
+        stencilRefSpan(span->face, stencil + row + x0, depthPass, passMask, count);
+        pass = passMask;
+    }
+
+    if (!pass) {
+        fill32(pixels, value, count);
+        return;
+    }
+
+    if (span->plane && depthMask) {
+        depthRefStore(depth + row + x0, spanZ, pass, count);
+    }
+    for (int i = 0; i < count; i++) {
+        if (pass[i]) {
+            memcpy(pixels + i * 4, &value, 4);
+        }
+    }
+}
+
+// Window coordinates x, y, z of vertex index from attribute 0 (z = 0 without
+// a third component). Vertices the near or far plane would clip are refused.
+static int fetchVertex(const struct BufferCopy *copy, GLint size, GLsizei stride, size_t offset,
+                       GLint index, float out[3]) {
+    int components = size >= 3 ? 3 : 2;
+    size_t at = offset + (size_t)index * stride;
+    if (at + components * sizeof(float) > (size_t)copy->size) {
+        return 0;
+    }
+
+    float ndc[3] = {0.0f, 0.0f, 0.0f};
+    memcpy(ndc, copy->data + at, components * sizeof(float));
+    if (ndc[2] < -1.0f || ndc[2] > 1.0f) {
+        return 0;
+    }
+
+    out[0] = viewport[0] + (ndc[0] + 1.0f) * 0.5f * viewport[2];
+    out[1] = viewport[1] + (ndc[1] + 1.0f) * 0.5f * viewport[3];
+    out[2] = depthRange[0] + (ndc[2] + 1.0f) * 0.5f * (depthRange[1] - depthRange[0]);
+    return 1;
+}
+
+static int modelDraw(GLenum mode, GLint first, GLsizei count) {
+    GLuint buffer;
+    GLint size;
+    GLenum type;
+    GLsizei stride;
+    const void *pointer;
+
+    if (!stateAttribSource(0, &buffer, &size, &type, &stride, &pointer) || type != GL_FLOAT || size < 2) {
+        return 0;
+    }
+    if (mode != GL_TRIANGLES && mode != GL_TRIANGLE_STRIP && mode != GL_TRIANGLE_FAN) {
+        return 0;
+    }
+
+    const struct BufferCopy *copy = NULL;
+    for (int i = 0; i < bufferCount; i++) {
+        if (buffers[i].buffer == buffer) copy = &buffers[i];
+    }
+    if (!copy) {
+        return 0;
+    }
+
+    // Clipping to the viewport stands in for clipping to the view volume
+    int clipX0 = viewport[0] > 0 ? viewport[0] : 0;
+    int clipY0 = viewport[1] > 0 ? viewport[1] : 0;
+    int clipX1 = viewport[0] + viewport[2] < model.width ? viewport[0] + viewport[2] : model.width;
+    int clipY1 = viewport[1] + viewport[3] < model.height ? viewport[1] + viewport[3] : model.height;
+
+    int triangles = mode == GL_TRIANGLES ? count / 3 : count - 2;
+    for (int t = 0; t < triangles; t++) {
+        GLint index[3];
+        if (mode == GL_TRIANGLES) {
+            index[0] = first + t * 3, index[1] = first + t * 3 + 1, index[2] = first + t * 3 + 2;
+        } else if (mode == GL_TRIANGLE_STRIP) {
+            // Every other strip triangle is flipped back to the strip's winding
+            index[0] = first + t, index[1] = first + t + 1 + (t & 1), index[2] = first + t + 2 - (t & 1);
+        } else {
+            index[0] = first, index[1] = first + t + 1, index[2] = first + t + 2;
+        }
+
+        float v[3][3];
+        for (int i = 0; i < 3; i++) {
+            if (!fetchVertex(copy, size, stride, (size_t)pointer, index[i], v[i])) {
+                return 0;
+            }
+        }
+
+        // Counterclockwise in window coordinates is front facing
+        struct SpanContext span;
+        span.face = !stencilTest ? NULL : rasterArea(v[0], v[1], v[2]) > 0.0f ? &faces[0] : &faces[1];
+
+        // Without a depth buffer the depth test always passes and writes nothing
+        float plane[3];
+        span.plane = NULL;
+        if (depthTest && depthScale > 0.0f) {
+            rasterPlane(v[0], v[1], v[2], v[0][2], v[1][2], v[2][2], plane);
+            span.plane = plane;
+        }
+        rasterTriangle(v[0], v[1], v[2], clipX0, clipY0, clipX1, clipY1, shadeSpan, &span);
+    }
+    return 1;
+}
+
+void pipeDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArrays(mode, first, count);
+    if (!enabled) {
+        return;
+    }
+
+    double start = timeNowMs();
+    touched = 1;
+    resizeModel();
+    if (!modelDraw(mode, first, count) || unmodelledCaps) {
+        followed = 0;
+    }
+    modelMs += timeNowMs() - start;
+}
+
+// The stencil readback overwrites alpha, which can only be put back with a
+// clear when the expected alpha is the same everywhere
+static int uniformAlpha(int *alpha) {
+    size_t pixels = (size_t)model.width * model.height;
+    *alpha = model.pixels[3];
+    for (size_t i = 1; i < pixels; i++) {
+        if (model.pixels[i * 4 + 3] != *alpha) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void restoreAlpha(int alpha) {
+    GLboolean mask[4], scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLfloat previous[4];
+    glGetBooleanv(GL_COLOR_WRITEMASK, mask);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, previous);
+
+    glDisable(GL_SCISSOR_TEST);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+    glClearColor(0.0f, 0.0f, 0.0f, alpha / 255.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glClearColor(previous[0], previous[1], previous[2], previous[3]);
+    glColorMask(mask[0], mask[1], mask[2], mask[3]);
+    if (scissor) glEnable(GL_SCISSOR_TEST);
+}
+
+// Counts the pixels whose read back stencil (frame alpha, rows bottom to top)
+// differs from the model's
+static long compareStencil() {
+    long mismatched = 0;
+    for (int y = 0; y < model.height; y++) {
+        const unsigned char *expected = stencil + (size_t)(model.height - 1 - y) * model.width;
+        const unsigned char *actual = frame + (size_t)y * model.width * 4 + 3;
+        for (int x = 0; x < model.width; x++) {
+            mismatched += actual[x * 4] != expected[x];
+        }
+    }
+    return mismatched;
+}
+
+void pipeCheckFrame() {
+    // Suites that do not draw through the pipe have nothing to compare
+    if (!enabled || !touched) {
+        return;
+    }
+
+    // followed restarts with every frame; the caps stay until disabled
+    touched = 0;
+    if (!followed || unmodelledCaps) {
+        framesSkipped++;
+        followed = 1;
+        return;
+    }
+
+    double start = timeNowMs();
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    int alpha;
+    long stencilMismatched = 0;
+    int stencilChecked = uniformAlpha(&alpha) &&
+                         stencilReadback(0, 0, model.width, model.height, frame);
+    if (stencilChecked) {
+        restoreAlpha(alpha);
+        stencilMismatched = compareStencil();
+    } else {
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, model.width, model.height, GL_RGBA, GL_UNSIGNED_BYTE, frame);
+    }
+    readbackMs += timeNowMs() - start;
+
+    // Only red, green and blue are compared, so the stencil in alpha is ignored here
+    struct CompareResult result;
+    compareFrame(&model, 0, 0, frame, model.width, model.height, REFERENCE_TOLERANCE, NULL, &result);
+
+    framesChecked++;
+    stencilFramesChecked += stencilChecked;
+    if (result.mismatched > 0 || stencilMismatched > 0) framesFailed++;
+    if (stencilMismatched > worstStencilMismatched) worstStencilMismatched = stencilMismatched;
+    if (result.mismatched > worstMismatched) worstMismatched = result.mismatched;
+    if (result.maxError > worstError) worstError = result.maxError;
+}
+
+static void dumpModel() {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.reference.png", dumpDir, current->name);
+    if (pngWrite(path, model.width, model.height, model.pixels)) {
+        printf("  reference: %s\n", path);
+    }
+
+    size_t pixels = (size_t)model.width * model.height;
+    unsigned char *rgba = malloc(pixels * 4);
+    for (size_t i = 0; i < pixels; i++) {
+        rgba[i * 4] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = stencil[i];
+        rgba[i * 4 + 3] = 255;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s.stencil.png", dumpDir, current->name);
+    if (pngWrite(path, model.width, model.height, rgba)) {
+        printf("  stencil: %s\n", path);
+    }
+
+    // Depth as gray, the top 8 bits of the stored value
+    if (depthScale > 0.0f) {
+        for (size_t i = 0; i < pixels; i++) {
+            unsigned char value = (unsigned char)lrintf(depth[i] / depthScale * 255.0f);
+            rgba[i * 4] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = value;
+        }
+
+        snprintf(path, sizeof(path), "%s/%s.depth.png", dumpDir, current->name);
+        if (pngWrite(path, model.width, model.height, rgba)) {
+            printf("  depth: %s\n", path);
+        }
+    }
+    free(rgba);
+}
+
+int pipeEnd() {
+    if (!enabled) {
+        return 1;
+    }
+
+    stencilReadbackRelease();
+    if (framesChecked + framesSkipped == 0) {
+        return 1;
+    }
+
+    int passed = framesFailed == 0;
+    if (framesChecked == 0) {
+        printf("%s: reference skipped, the model could not follow the draws\n", current->name);
+    } else {
+        printf("%s: reference %s, %d/%d frames failed, worst %ld mismatched pixels, max error %d, model %.3f ms/frame\n",
+               current->name, passed ? "PASS" : "FAIL", framesFailed, framesChecked, worstMismatched, worstError,
+               modelMs / (framesChecked + framesSkipped));
+        printf("%s: stencil read back in %d/%d frames, worst %ld mismatched pixels, readback %.3f ms/frame\n",
+               current->name, stencilFramesChecked, framesChecked, worstStencilMismatched,
+               readbackMs / framesChecked);
+        if (dumpDir) {
+            dumpModel();
+        }
+    }
+    return passed;
+}
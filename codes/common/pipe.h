@@ -0,0 +1,62 @@
+#ifndef PIPE_H
+#define PIPE_H
+
+#include <GLES2/gl2.h>
+
+struct Suite;
+
+// Drawing calls a CPU reference can follow. Every pipe* function issues the GL
+// call of the same name. With --reference the calls are also replayed on a
+// software pipeline at the framebuffer size (raster.h, depthRef.h,
+// stencilRef.h), and each frame is compared with it after draw(), so the
+// expected image is computed from the suite's own state changes rather than
+// stored. The stencil values are read back with stencilReadback.h and checked
+// too when the expected alpha is uniform, since the readback borrows alpha.
+//   --reference           check every frame of the suites drawn through the pipe
+//   --reference-dump DIR  write <suite>.reference.png, <suite>.stencil.png and
+//                         <suite>.depth.png (the expected planes of the last frame)
+//
+// The model covers what the fixed-function suites use: triangles whose
+// attribute 0 holds float x, y (and z) in normalized device coordinates inside
+// the near and far planes (w = 1), a flat color set with pipeUniform3f or
+// pipeUniform3fv, viewport, depth range, clears, and the depth and stencil
+// tests. A draw it cannot follow marks the frame as unchecked.
+
+// Returns how many arguments it consumed (0 if arg is not a reference flag).
+int pipeParseArg(const char *arg, const char *value);
+
+// Resets the model to the GL defaults restored by resetGLState(); called before
+// init() so the state a suite sets there is followed too.
+void pipeBegin(const struct Suite *suite);
+void pipeCheckFrame();
+
+// Prints the summary and returns 1 if every checked frame matched.
+int pipeEnd();
+
+void pipeClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void pipeClearStencil(GLint s);
+void pipeClear(GLbitfield mask);
+void pipeClearDepthf(GLfloat d);
+void pipeViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void pipeDepthRangef(GLfloat n, GLfloat f);
+void pipeEnable(GLenum cap);
+void pipeDisable(GLenum cap);
+
+void pipeDepthFunc(GLenum func);
+void pipeDepthMask(GLboolean flag);
+
+void pipeStencilFunc(GLenum func, GLint ref, GLuint mask);
+void pipeStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+void pipeStencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+void pipeStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass);
+void pipeStencilMask(GLuint mask);
+void pipeStencilMaskSeparate(GLenum face, GLuint mask);
+
+// Uploads to the bound GL_ARRAY_BUFFER and keeps a copy for the model.
+void pipeBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+
+void pipeUniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z);
+void pipeUniform3fv(GLint location, GLsizei count, const GLfloat *value);
+void pipeDrawArrays(GLenum mode, GLint first, GLsizei count);
+
+#endif
@@ -0,0 +1,356 @@
+#include "platform.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2ext.h>
+#ifndef PLATFORM_NO_GLFW
+#include <GLFW/glfw3.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int headless = 0;
+static int fbWidth, fbHeight, fbSamples;
+static int framesDrawn = 0;
+
+#ifndef PLATFORM_NO_GLFW
+static GLFWwindow *window;
+#endif
+
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+static EGLConfig eglContextConfig = NULL;
+static int configlessContexts = 0;
+static GLuint offscreenFBO, offscreenColor, offscreenDepth, offscreenStencil;
+
+void platformParseArgs(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        }
+    }
+
+#ifdef PLATFORM_NO_GLFW
+    headless = 1;
+#endif
+}
+
+// Picks a config with exactly 8 bits per color channel. eglChooseConfig sorts
+// deeper formats (RGB10_A2) first, which would change how the suites round colors.
+static int chooseConfig(EGLint surfaceType, int samples, EGLConfig *config) {
+    EGLint attribs[] = {
+        EGL_SURFACE_TYPE, surfaceType,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_STENCIL_SIZE, 8,
+        EGL_SAMPLE_BUFFERS, samples > 0 ? 1 : 0,
+        EGL_SAMPLES, samples,
+        EGL_NONE
+    };
+
+    EGLConfig configs[64];
+    EGLint count = 0;
+    if (!eglChooseConfig(eglDisplay, attribs, configs, 64, &count)) {
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        EGLint red, alpha;
+        eglGetConfigAttrib(eglDisplay, configs[i], EGL_RED_SIZE, &red);
+        eglGetConfigAttrib(eglDisplay, configs[i], EGL_ALPHA_SIZE, &alpha);
+        if (red == 8 && alpha == 8) {
+            *config = configs[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int createOffscreenFramebuffer(int width, int height) {
+    const char *extensions = (const char *) glGetString(GL_EXTENSIONS);
+
+    glGenFramebuffers(1, &offscreenFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreenFBO);
+
+    glGenRenderbuffers(1, &offscreenColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8_OES, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColor);
+
+    if (extensions && strstr(extensions, "GL_OES_packed_depth_stencil")) {
+        glGenRenderbuffers(1, &offscreenDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+    } else {
+        glGenRenderbuffers(1, &offscreenDepth);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+
+        glGenRenderbuffers(1, &offscreenStencil);
+        glBindRenderbuffer(GL_RENDERBUFFER, offscreenStencil);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenStencil);
+    }
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Creates the headless render target for the current context: a pbuffer when
+// the display offers a matching config, otherwise an FBO.
+static int createHeadlessSurface(int width, int height, int samples) {
+    EGLConfig config = NULL;
+    int havePbuffer = 0;
+
+    // Without configless contexts every surface must share the context config.
+    if (eglContextConfig != NULL) {
+        config = eglContextConfig;
+        havePbuffer = 1;
+    } else {
+        havePbuffer = chooseConfig(EGL_PBUFFER_BIT, samples, &config);
+        if (!havePbuffer && samples > 0) {
+            havePbuffer = chooseConfig(EGL_PBUFFER_BIT, 0, &config);
+        }
+    }
+
+    if (havePbuffer) {
+        EGLint surfaceAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+        eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttribs);
+    }
+
+    // Surfaceless contexts have no default framebuffer, so render into an FBO.
+    if (eglSurface == EGL_NO_SURFACE) {
+        if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+            fprintf(stderr, "Failed to make surfaceless EGL context current (0x%x)\n", eglGetError());
+            return 0;
+        }
+        if (!createOffscreenFramebuffer(width, height)) {
+            fprintf(stderr, "Failed to create offscreen framebuffer\n");
+            return 0;
+        }
+    } else if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        fprintf(stderr, "Failed to make EGL context current (0x%x)\n", eglGetError());
+        return 0;
+    }
+
+    return 1;
+}
+
+static void destroyHeadlessSurface() {
+    if (offscreenFBO) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteRenderbuffers(1, &offscreenColor);
+        glDeleteRenderbuffers(1, &offscreenDepth);
+        if (offscreenStencil) {
+            glDeleteRenderbuffers(1, &offscreenStencil);
+        }
+        glDeleteFramebuffers(1, &offscreenFBO);
+        offscreenFBO = offscreenColor = offscreenDepth = offscreenStencil = 0;
+    }
+
+    if (eglSurface != EGL_NO_SURFACE) {
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroySurface(eglDisplay, eglSurface);
+        eglSurface = EGL_NO_SURFACE;
+    }
+}
+
+static int headlessInit(int width, int height, int samples) {
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if (getPlatformDisplay && clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, NULL, NULL)) {
+        fprintf(stderr, "Failed to initialize EGL display\n");
+        return 0;
+    }
+
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    // A configless context can be made current with pbuffers of any sample
+    // count, which lets the runner give each suite the config it asks for.
+    const char *displayExtensions = eglQueryString(eglDisplay, EGL_EXTENSIONS);
+    configlessContexts = displayExtensions &&
+        (strstr(displayExtensions, "EGL_KHR_no_config_context") || strstr(displayExtensions, "EGL_MESA_configless_context"));
+
+    EGLConfig config = NULL;
+    if (!configlessContexts) {
+        if (!chooseConfig(EGL_PBUFFER_BIT, samples, &config) && samples > 0) {
+            chooseConfig(EGL_PBUFFER_BIT, 0, &config);
+        }
+        eglContextConfig = config;
+    }
+
+    EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglContext == EGL_NO_CONTEXT) {
+        fprintf(stderr, "Failed to create EGL context (0x%x)\n", eglGetError());
+        return 0;
+    }
+
+    return createHeadlessSurface(width, height, samples);
+}
+
+int platformInit(const char *title, int width, int height, int samples) {
+    fbWidth = width;
+    fbHeight = height;
+    fbSamples = samples;
+    framesDrawn = 0;
+
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        if (!glfwInit()) {
+            fprintf(stderr, "Failed to initialize GLFW, falling back to headless EGL\n");
+            headless = 1;
+        }
+    }
+
+    if (!headless) {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        glfwWindowHint(GLFW_SAMPLES, samples);
+
+        window = glfwCreateWindow(width, height, title, NULL, NULL);
+        if (!window) {
+            fprintf(stderr, "Failed to create GLFW window\n");
+            glfwTerminate();
+            return 0;
+        }
+
+        glfwMakeContextCurrent(window);
+        return 1;
+    }
+#else
+    (void)title;                    // only a window shows it
+#endif
+
+    return headlessInit(width, height, samples);
+}
+
+void platformResize(const char *title, int width, int height, int samples) {
+    framesDrawn = 0;
+
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        // The window keeps the sample count it was created with.
+        glfwSetWindowTitle(window, title);
+        glfwSetWindowSize(window, width, height);
+        glfwSetWindowShouldClose(window, 0);
+        fbWidth = width;
+        fbHeight = height;
+        return;
+    }
+#else
+    (void)title;
+#endif
+
+    if (width == fbWidth && height == fbHeight && samples == fbSamples) {
+        return;
+    }
+
+    destroyHeadlessSurface();
+    if (!createHeadlessSurface(width, height, samples)) {
+        exit(EXIT_FAILURE);
+    }
+
+    fbWidth = width;
+    fbHeight = height;
+    fbSamples = samples;
+}
+
+void platformTerminate() {
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        glfwTerminate();
+        return;
+    }
+#endif
+
+    destroyHeadlessSurface();
+
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(eglDisplay, eglContext);
+    eglTerminate(eglDisplay);
+}
+
+int platformShouldClose() {
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        return glfwWindowShouldClose(window);
+    }
+#endif
+
+    // Nobody can close an offscreen surface, so render a single frame.
+    return framesDrawn > 0;
+}
+
+void platformSwapBuffers() {
+    framesDrawn++;
+
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        return;
+    }
+#endif
+
+    glFinish();
+}
+
+void platformGetFramebufferSize(int *width, int *height) {
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        glfwGetFramebufferSize(window, width, height);
+        return;
+    }
+#endif
+
+    *width = fbWidth;
+    *height = fbHeight;
+}
+
+int platformIsHeadless() {
+    return headless;
+}
+
+GLuint platformFramebuffer() {
+    return offscreenFBO;
+}
+
+int platformClampTargetSide(int side) {
+    GLint maxSize = 0, viewport[2];
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxSize);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, viewport);
+    if (side > maxSize) side = maxSize;
+    if (side > viewport[0]) side = viewport[0];
+    if (side > viewport[1]) side = viewport[1];
+    if (side > 4096) side = 4096;
+    return side;
+}
+
+void *platformGetProcAddress(const char *name) {
+#ifndef PLATFORM_NO_GLFW
+    if (!headless) {
+        return (void *) glfwGetProcAddress(name);
+    }
+#endif
+
+    return (void *) eglGetProcAddress(name);
+}
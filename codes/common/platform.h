@@ -0,0 +1,41 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <GLES2/gl2.h>
+
+// Context creation shared by every suite.
+//
+// The default backend is a GLFW window, exactly like the original programs.
+// Passing --headless (or building with -DPLATFORM_NO_GLFW) creates an EGL
+// context instead: a pbuffer when the driver offers an RGBA8/D24S8 config,
+// otherwise a surfaceless context rendering into an offscreen FBO. Headless
+// frames are never swapped, so the loop runs as fast as the driver allows.
+
+// Consumes the platform flags (--headless) and leaves the rest untouched.
+void platformParseArgs(int argc, char **argv);
+
+int platformInit(const char *title, int width, int height, int samples);
+void platformTerminate();
+
+// Retargets the existing context to a new framebuffer size so several suites
+// can share it. Headless surfaces are recreated; windows are resized.
+void platformResize(const char *title, int width, int height, int samples);
+
+int platformShouldClose();
+void platformSwapBuffers();
+
+void platformGetFramebufferSize(int *width, int *height);
+int platformIsHeadless();
+
+// Framebuffer the suites render into. 0 for windows and pbuffers, the
+// offscreen FBO for surfaceless contexts.
+GLuint platformFramebuffer();
+
+// Largest square offscreen target side up to the requested one: limited by
+// GL_MAX_RENDERBUFFER_SIZE, GL_MAX_VIEWPORT_DIMS and 4096 so the readbacks of
+// the offscreen harnesses stay affordable.
+int platformClampTargetSide(int side);
+
+void *platformGetProcAddress(const char *name);
+
+#endif
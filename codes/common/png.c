@@ -0,0 +1,224 @@
+#include "png.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+static const unsigned char signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+
+static unsigned int readU32(const unsigned char *p) {
+    return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3];
+}
+
+static void writeU32(unsigned char *p, unsigned int v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static unsigned char *readFile(const char *path, long *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = malloc(*size);
+    if (data && fread(data, 1, *size, file) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+static int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+// Undoes the per-row filters in place. bpp is bytes per pixel.
+static int unfilter(unsigned char *data, int width, int height, int bpp) {
+    int stride = width * bpp;
+    unsigned char *prev = NULL;
+
+    for (int y = 0; y < height; y++) {
+        unsigned char *row = data + y * (stride + 1);
+        int filter = row[0];
+        unsigned char *cur = row + 1;
+
+        for (int x = 0; x < stride; x++) {
+            int a = x >= bpp ? cur[x - bpp] : 0;
+            int b = prev ? prev[x] : 0;
+            int c = prev && x >= bpp ? prev[x - bpp] : 0;
+
+            switch (filter) {
+            case 0: break;
+            case 1: cur[x] += a; break;
+            case 2: cur[x] += b; break;
+            case 3: cur[x] += (a + b) / 2; break;
+            case 4: cur[x] += paeth(a, b, c); break;
+            default: return 0;
+            }
+        }
+        prev = cur;
+    }
+    return 1;
+}
+
+int pngRead(const char *path, struct Image *image) {
+    memset(image, 0, sizeof(*image));
+
+    long size = 0;
+    unsigned char *file = readFile(path, &size);
+    if (!file) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 0;
+    }
+
+    if (size < 8 || memcmp(file, signature, 8) != 0) {
+        fprintf(stderr, "%s is not a PNG file\n", path);
+        free(file);
+        return 0;
+    }
+
+    int width = 0, height = 0, colorType = -1, bitDepth = 0, interlace = 0;
+    unsigned char *idat = NULL;
+    long idatSize = 0;
+
+    long pos = 8;
+    while (pos + 12 <= size) {
+        unsigned int length = readU32(file + pos);
+        const unsigned char *type = file + pos + 4;
+        const unsigned char *chunk = file + pos + 8;
+        if (pos + 12 + (long)length > size) {
+            break;
+        }
+
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = readU32(chunk);
+            height = readU32(chunk + 4);
+            bitDepth = chunk[8];
+            colorType = chunk[9];
+            interlace = chunk[12];
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            idat = realloc(idat, idatSize + length);
+            memcpy(idat + idatSize, chunk, length);
+            idatSize += length;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
+    }
+    free(file);
+
+    int channels = colorType == 6 ? 4 : colorType == 2 ? 3 : colorType == 0 ? 1 : 0;
+    if (!idat || width <= 0 || height <= 0 || bitDepth != 8 || channels == 0 || interlace != 0) {
+        fprintf(stderr, "%s: unsupported PNG format\n", path);
+        free(idat);
+        return 0;
+    }
+
+    uLongf rawSize = (uLongf)(width * channels + 1) * height;
+    unsigned char *raw = malloc(rawSize);
+    int ok = uncompress(raw, &rawSize, idat, idatSize) == Z_OK &&
+             rawSize == (uLongf)(width * channels + 1) * height &&
+             unfilter(raw, width, height, channels);
+    free(idat);
+
+    if (!ok) {
+        fprintf(stderr, "%s: corrupt image data\n", path);
+        free(raw);
+        return 0;
+    }
+
+    image->width = width;
+    image->height = height;
+    image->pixels = malloc((size_t)width * height * 4);
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char *src = raw + y * (width * channels + 1) + 1;
+        unsigned char *dst = image->pixels + (size_t)y * width * 4;
+        for (int x = 0; x < width; x++, src += channels, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = channels >= 3 ? src[1] : src[0];
+            dst[2] = channels >= 3 ? src[2] : src[0];
+            dst[3] = channels == 4 ? src[3] : 255;
+        }
+    }
+
+    free(raw);
+    return 1;
+}
+
+static void writeChunk(FILE *file, const char *type, const unsigned char *data, unsigned int length) {
+    unsigned char header[8];
+    writeU32(header, length);
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, file);
+    if (length) {
+        fwrite(data, 1, length, file);
+    }
+
+    uLong crc = crc32(0, header + 4, 4);
+    if (length) {
+        crc = crc32(crc, data, length);
+    }
+    unsigned char trailer[4];
+    writeU32(trailer, crc);
+    fwrite(trailer, 1, 4, file);
+}
+
+int pngWrite(const char *path, int width, int height, const unsigned char *rgba) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return 0;
+    }
+
+    // Every row uses filter 0 (none); zlib does the real work
+    uLong rawSize = (uLong)(width * 4 + 1) * height;
+    unsigned char *raw = malloc(rawSize);
+    for (int y = 0; y < height; y++) {
+        raw[y * (width * 4 + 1)] = 0;
+        memcpy(raw + y * (width * 4 + 1) + 1, rgba + (size_t)y * width * 4, width * 4);
+    }
+
+    uLongf packedSize = compressBound(rawSize);
+    unsigned char *packed = malloc(packedSize);
+    compress(packed, &packedSize, raw, rawSize);
+
+    unsigned char header[13];
+    writeU32(header, width);
+    writeU32(header + 4, height);
+    header[8] = 8;   // bit depth
+    header[9] = 6;   // RGBA
+    header[10] = 0;
+    header[11] = 0;
+    header[12] = 0;
+
+    fwrite(signature, 1, 8, file);
+    writeChunk(file, "IHDR", header, 13);
+    writeChunk(file, "IDAT", packed, packedSize);
+    writeChunk(file, "IEND", NULL, 0);
+    fclose(file);
+
+    free(raw);
+    free(packed);
+    return 1;
+}
+
+void imageFree(struct Image *image) {
+    free(image->pixels);
+    image->pixels = NULL;
+    image->width = 0;
+    image->height = 0;
+}
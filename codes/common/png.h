@@ -0,0 +1,16 @@
+#ifndef PNG_H
+#define PNG_H
+
+// Minimal PNG support for the golden images: 8-bit RGB/RGBA/gray, non-interlaced.
+// Pixels are always RGBA, rows top to bottom.
+struct Image {
+    int width;
+    int height;
+    unsigned char *pixels;
+};
+
+int pngRead(const char *path, struct Image *image);
+int pngWrite(const char *path, int width, int height, const unsigned char *rgba);
+void imageFree(struct Image *image);
+
+#endif
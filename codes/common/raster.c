@@ -0,0 +1,115 @@
+#include "raster.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define SUBPIXEL (1 << RASTER_SUBPIXEL_BITS)
+
+struct Edge {
+    int64_t stepX;      // change of the edge function per pixel to the right
+    int64_t stepY;      // per row up
+    int64_t origin;     // at the center of pixel (0, 0), minus the tie-break bias
+};
+
+static int64_t floorDiv(int64_t n, int64_t d) {
+    return n >= 0 ? n / d : -((-n + d - 1) / d);
+}
+
+// Edge a -> b of a counterclockwise triangle: the function is positive on the
+// interior side. Centers exactly on the edge count only for left edges (going
+// down) and top edges (horizontal, going left), hence the bias.
+static struct Edge setupEdge(const int64_t a[2], const int64_t b[2]) {
+    int64_t dx = b[0] - a[0], dy = b[1] - a[1];
+    int topLeft = dy < 0 || (dy == 0 && dx < 0);
+    struct Edge edge;
+
+    edge.stepX = -dy * SUBPIXEL;
+    edge.stepY = dx * SUBPIXEL;
+    edge.origin = dx * (SUBPIXEL / 2 - a[1]) - dy * (SUBPIXEL / 2 - a[0]) - (topLeft ? 0 : 1);
+    return edge;
+}
+
+float rasterArea(const float v0[2], const float v1[2], const float v2[2]) {
+    return (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+}
+
+void rasterPlane(const float v0[2], const float v1[2], const float v2[2],
+                 float z0, float z1, float z2, float plane[3]) {
+    double ax = v1[0] - v0[0], ay = v1[1] - v0[1];
+    double bx = v2[0] - v0[0], by = v2[1] - v0[1];
+    double za = z1 - z0, zb = z2 - z0;
+    double area = ax * by - bx * ay;
+    double dzdx = 0.0, dzdy = 0.0;
+
+    if (area != 0.0) {
+        dzdx = (za * by - zb * ay) / area;
+        dzdy = (ax * zb - bx * za) / area;
+    }
+    plane[0] = (float)dzdx;
+    plane[1] = (float)dzdy;
+    plane[2] = (float)(z0 + dzdx * (0.5 - v0[0]) + dzdy * (0.5 - v0[1]));
+}
+
+void rasterTriangle(const float v0[2], const float v1[2], const float v2[2],
+                    int clipX0, int clipY0, int clipX1, int clipY1,
+                    RasterSpan span, void *context) {
+    int64_t p[3][2];
+    const float *v[3] = {v0, v1, v2};
+
+    for (int i = 0; i < 3; i++) {
+        p[i][0] = (int64_t)lrintf(v[i][0] * SUBPIXEL);
+        p[i][1] = (int64_t)lrintf(v[i][1] * SUBPIXEL);
+    }
+
+    int64_t area = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[2][0] - p[0][0]) * (p[1][1] - p[0][1]);
+    if (area == 0) {
+        return;
+    }
+
+    // Traverse counterclockwise; coverage does not depend on the winding
+    int second = area > 0 ? 1 : 2, third = area > 0 ? 2 : 1;
+    struct Edge edges[3] = {
+        setupEdge(p[0], p[second]),
+        setupEdge(p[second], p[third]),
+        setupEdge(p[third], p[0]),
+    };
+
+    int64_t minY = p[0][1], maxY = p[0][1], minX = p[0][0], maxX = p[0][0];
+    for (int i = 1; i < 3; i++) {
+        if (p[i][1] < minY) minY = p[i][1];
+        if (p[i][1] > maxY) maxY = p[i][1];
+        if (p[i][0] < minX) minX = p[i][0];
+        if (p[i][0] > maxX) maxX = p[i][0];
+    }
+
+    int y0 = (int)floorDiv(minY, SUBPIXEL), y1 = (int)floorDiv(maxY, SUBPIXEL) + 1;
+    int x0 = (int)floorDiv(minX, SUBPIXEL), x1 = (int)floorDiv(maxX, SUBPIXEL) + 1;
+    if (y0 < clipY0) y0 = clipY0;
+    if (y1 > clipY1) y1 = clipY1;
+    if (x0 < clipX0) x0 = clipX0;
+    if (x1 > clipX1) x1 = clipX1;
+
+    for (int y = y0; y < y1; y++) {
+        // Intersect the half-planes: each edge bounds x from one side
+        int64_t left = x0, right = x1;
+
+        for (int e = 0; e < 3 && left < right; e++) {
+            int64_t value = edges[e].origin + edges[e].stepY * y;
+
+            if (edges[e].stepX > 0) {
+                // value + stepX * x >= 0
+                int64_t first = -floorDiv(value, edges[e].stepX);
+                if (first > left) left = first;
+            } else if (edges[e].stepX < 0) {
+                int64_t last = floorDiv(value, -edges[e].stepX) + 1;
+                if (last < right) right = last;
+            } else if (value < 0) {
+                right = left;
+            }
+        }
+
+        if (left < right) {
+            span(context, y, (int)left, (int)right);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+// Triangle traversal for the CPU references. Vertices are in window
+// coordinates (pixels, y up) and are snapped to 1/256 pixel like the GPU's
+// subpixel grid. A pixel is covered when its center is inside the triangle;
+// centers exactly on an edge belong to top and left edges only, so triangles
+// sharing an edge never both cover a pixel.
+
+#define RASTER_SUBPIXEL_BITS 8
+
+// Called once per covered run of pixels [x0, x1) of row y, rows bottom to top.
+typedef void (*RasterSpan)(void *context, int y, int x0, int x1);
+
+// Twice the signed area of the triangle: positive when counterclockwise.
+float rasterArea(const float v0[2], const float v1[2], const float v2[2]);
+
+// The plane through the vertex values z0, z1, z2, evaluated at pixel centers:
+// the value at the center of pixel (x, y) is plane[0] * x + plane[1] * y + plane[2].
+void rasterPlane(const float v0[2], const float v1[2], const float v2[2],
+                 float z0, float z1, float z2, float plane[3]);
+
+// Emits the spans of the triangle inside the clip rectangle [clipX0, clipX1) x
+// [clipY0, clipY1). Either winding is accepted; degenerate triangles emit nothing.
+void rasterTriangle(const float v0[2], const float v1[2], const float v2[2],
+                    int clipX0, int clipY0, int clipX1, int clipY1,
+                    RasterSpan span, void *context);
+
+#endif
@@ -0,0 +1,137 @@
+#include "shader.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Open-addressed tables; sizes are powers of two and comfortably larger than
+// anything the suites declare (GLES2 guarantees only 8 attributes anyway).
+#define MAX_PROGRAMS 256
+#define UNIFORM_SLOTS 64
+#define ATTRIB_SLOTS 16
+#define MAX_NAME 64
+
+struct Variable {
+    uint32_t hash;
+    GLint location;         // -1 marks an empty slot
+    char name[MAX_NAME];
+};
+
+struct Reflection {
+    GLuint program;         // 0 marks an empty slot
+    struct Variable uniforms[UNIFORM_SLOTS];
+    struct Variable attribs[ATTRIB_SLOTS];
+};
+
+static struct Reflection reflections[MAX_PROGRAMS];
+
+static uint32_t hashName(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static struct Reflection *findReflection(GLuint program, int create) {
+    for (int i = 0; i < MAX_PROGRAMS; i++) {
+        struct Reflection *r = &reflections[(program + i) & (MAX_PROGRAMS - 1)];
+        if (r->program == program) {
+            return r;
+        }
+        if (r->program == 0) {
+            return create ? r : NULL;
+        }
+    }
+    return NULL;
+}
+
+static void insertVariable(struct Variable *slots, int slotCount, const char *name, GLint location) {
+    uint32_t hash = hashName(name);
+
+    for (int i = 0; i < slotCount; i++) {
+        struct Variable *v = &slots[(hash + i) & (slotCount - 1)];
+        if (v->location < 0) {
+            v->hash = hash;
+            v->location = location;
+            strncpy(v->name, name, MAX_NAME - 1);
+            v->name[MAX_NAME - 1] = '\0';
+            return;
+        }
+    }
+}
+
+static GLint lookupVariable(const struct Variable *slots, int slotCount, const char *name) {
+    uint32_t hash = hashName(name);
+
+    for (int i = 0; i < slotCount; i++) {
+        const struct Variable *v = &slots[(hash + i) & (slotCount - 1)];
+        if (v->location < 0) {
+            return -1;
+        }
+        if (v->hash == hash && strcmp(v->name, name) == 0) {
+            return v->location;
+        }
+    }
+    return -1;
+}
+
+void loadProgramReflection(GLuint program) {
+    struct Reflection *r = findReflection(program, 1);
+    if (!r) {
+        return;
+    }
+
+    // Program names are reused after glDeleteProgram, so always start over
+    r->program = program;
+    for (int i = 0; i < UNIFORM_SLOTS; i++) r->uniforms[i].location = -1;
+    for (int i = 0; i < ATTRIB_SLOTS; i++) r->attribs[i].location = -1;
+
+    GLint count = 0;
+    char name[MAX_NAME];
+    GLint size;
+    GLenum type;
+
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    for (GLint i = 0; i < count; i++) {
+        glGetActiveUniform(program, i, sizeof(name), NULL, &size, &type, name);
+        GLint location = glGetUniformLocation(program, name);
+
+        // Arrays are reported as "name[0]"; register the plain name as well
+        char *bracket = strchr(name, '[');
+        if (bracket) {
+            insertVariable(r->uniforms, UNIFORM_SLOTS, name, location);
+            *bracket = '\0';
+        }
+        insertVariable(r->uniforms, UNIFORM_SLOTS, name, location);
+    }
+
+    glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+    for (GLint i = 0; i < count; i++) {
+        glGetActiveAttrib(program, i, sizeof(name), NULL, &size, &type, name);
+        insertVariable(r->attribs, ATTRIB_SLOTS, name, glGetAttribLocation(program, name));
+    }
+}
+
+GLint programUniform(GLuint program, const char *name) {
+    const struct Reflection *r = findReflection(program, 0);
+    if (!r) {
+        return glGetUniformLocation(program, name);
+    }
+
+    GLint location = lookupVariable(r->uniforms, UNIFORM_SLOTS, name);
+
+    // Individual array elements other than [0] are not in the table
+    if (location < 0 && strchr(name, '[')) {
+        location = glGetUniformLocation(program, name);
+    }
+    return location;
+}
+
+GLint programAttrib(GLuint program, const char *name) {
+    const struct Reflection *r = findReflection(program, 0);
+    if (!r) {
+        return glGetAttribLocation(program, name);
+    }
+    return lookupVariable(r->attribs, ATTRIB_SLOTS, name);
+}
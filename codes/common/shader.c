@@ -0,0 +1,397 @@
+#include "shader.h"
+#include "platform.h"
+
+#include <GLES2/gl2ext.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define MAX_SHADERS 128
+#define MAX_RECORDS 256
+#define MAX_VARIANTS 256
+
+struct CachedShader {
+    uint64_t hash;
+    GLenum type;
+    GLuint shader;
+};
+
+static struct CachedShader shaders[MAX_SHADERS];
+static int shaderCount;
+
+// Program binary support, looked up on first use
+static int binariesChecked;
+static const char *cacheDir;
+static PFNGLGETPROGRAMBINARYOESPROC getProgramBinary;
+static PFNGLPROGRAMBINARYOESPROC programBinary;
+
+static struct ShaderRecord records[MAX_RECORDS];
+static int recordCount;
+
+// Fragment sources rewritten for the precision override. They are kept for
+// the whole run because records refer to them and compare sources by address.
+static const char *fragmentPrecision;
+static char *variants[MAX_VARIANTS];
+static int variantCount;
+
+static const unsigned char binaryMagic[4] = {'G', 'L', 'P', 'B'};
+
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const char *text) {
+    // Include the terminator so "ab" + "c" and "a" + "bc" differ
+    return hashBytes(hash, text ? text : "", text ? strlen(text) + 1 : 1);
+}
+
+// Returns 0 and prints the info log if the source does not compile.
+static GLuint compileSource(const char *name, GLenum type, const char *source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        char log[1024] = "";
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "%s: %s shader failed to compile:\n%s\n", name,
+                type == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Returns the link status, printing the info log if the link failed.
+static int checkLinked(const char *name, GLuint program) {
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[1024] = "";
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        fprintf(stderr, "%s: program failed to link:\n%s\n", name, log);
+    }
+    return linked;
+}
+
+// Sets *cached to 0 when the table is full: the caller then owns the shader
+// and deletes it once the program is linked.
+static GLuint compileShader(const char *name, GLenum type, const char *source, int *cached) {
+    uint64_t hash = hashString(0xcbf29ce484222325ULL, source);
+
+    *cached = 1;
+    for (int i = 0; i < shaderCount; i++) {
+        if (shaders[i].hash == hash && shaders[i].type == type) {
+            return shaders[i].shader;
+        }
+    }
+
+    GLuint shader = compileSource(name, type, source);
+    if (!shader) {
+        return 0;
+    }
+
+    if (shaderCount < MAX_SHADERS) {
+        shaders[shaderCount].hash = hash;
+        shaders[shaderCount].type = type;
+        shaders[shaderCount].shader = shader;
+        shaderCount++;
+    } else {
+        *cached = 0;
+    }
+    return shader;
+}
+
+static void checkBinarySupport() {
+    binariesChecked = 1;
+
+    cacheDir = getenv("SHADER_CACHE_DIR");
+    if (!cacheDir) {
+        cacheDir = ".shader_cache";
+    }
+    if (cacheDir[0] == '\0') {
+        cacheDir = NULL;
+        return;
+    }
+
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+    GLint formats = 0;
+    if (extensions && strstr(extensions, "GL_OES_get_program_binary")) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+    }
+
+    if (formats > 0) {
+        getProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)platformGetProcAddress("glGetProgramBinaryOES");
+        programBinary = (PFNGLPROGRAMBINARYOESPROC)platformGetProcAddress("glProgramBinaryOES");
+    }
+    if (!getProgramBinary || !programBinary) {
+        cacheDir = NULL;
+        return;
+    }
+
+    mkdir(cacheDir, 0755);
+}
+
+static void binaryPath(char *path, size_t size, uint64_t key) {
+    snprintf(path, size, "%s/%016llx.bin", cacheDir, (unsigned long long)key);
+}
+
+// Returns a linked program, or 0 if there is no usable binary for this key.
+static GLuint loadBinary(uint64_t key) {
+    char path[1024];
+    binaryPath(path, sizeof(path), key);
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    unsigned char magic[4];
+    GLenum format = 0;
+    GLint length = 0;
+    void *binary = NULL;
+
+    if (fread(magic, 1, 4, file) == 4 && memcmp(magic, binaryMagic, 4) == 0 &&
+        fread(&format, sizeof(format), 1, file) == 1 &&
+        fread(&length, sizeof(length), 1, file) == 1 && length > 0) {
+        binary = malloc(length);
+        if (fread(binary, 1, length, file) != (size_t)length) {
+            free(binary);
+            binary = NULL;
+        }
+    }
+    fclose(file);
+
+    if (!binary) {
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    programBinary(program, format, binary, length);
+    free(binary);
+
+    // Drivers reject binaries from other builds through the link status
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void storeBinary(uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    void *binary = malloc(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &format, binary);
+
+    char path[1024], tempPath[1040];
+    binaryPath(path, sizeof(path), key);
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    // Write to a temporary file first so a concurrent run never reads half a binary
+    FILE *file = fopen(tempPath, "wb");
+    if (file && written > 0) {
+        GLint size = written;
+        fwrite(binaryMagic, 1, 4, file);
+        fwrite(&format, sizeof(format), 1, file);
+        fwrite(&size, sizeof(size), 1, file);
+        fwrite(binary, 1, written, file);
+        fclose(file);
+        rename(tempPath, path);
+    } else if (file) {
+        fclose(file);
+        remove(tempPath);
+    }
+    free(binary);
+}
+
+static void recordProgram(const char *name, const char *vertexSource, const char *fragmentSource) {
+    for (int i = 0; i < recordCount; i++) {
+        if (records[i].vertexSource == vertexSource && records[i].fragmentSource == fragmentSource) {
+            return;
+        }
+    }
+
+    if (recordCount < MAX_RECORDS) {
+        // Names may live on the caller's stack
+        records[recordCount].name = strdup(name);
+        records[recordCount].vertexSource = vertexSource;
+        records[recordCount].fragmentSource = fragmentSource;
+        recordCount++;
+    }
+}
+
+int shaderRecordCount() {
+    return recordCount;
+}
+
+const struct ShaderRecord *shaderRecord(int index) {
+    return &records[index];
+}
+
+void setShaderPrecision(const char *precision) {
+    fragmentPrecision = precision;
+}
+
+const char *shaderPrecision() {
+    return fragmentPrecision;
+}
+
+// Returns source with the qualifier of its "precision <q> float;" statement
+// replaced, or source itself if it has none or already uses that qualifier.
+static const char *precisionVariant(const char *source, const char *precision) {
+    const char *statement = strstr(source, "precision ");
+    while (statement) {
+        const char *qualifier = statement + strlen("precision ");
+        const char *end = strchr(qualifier, ' ');
+        if (end && strncmp(end, " float;", 7) == 0) {
+            break;
+        }
+        statement = strstr(qualifier, "precision ");
+    }
+
+    if (!statement) {
+        return source;
+    }
+
+    const char *qualifier = statement + strlen("precision ");
+    const char *end = strchr(qualifier, ' ');
+    if ((size_t)(end - qualifier) == strlen(precision) && strncmp(qualifier, precision, end - qualifier) == 0) {
+        return source;
+    }
+
+    size_t length = strlen(source) - (end - qualifier) + strlen(precision);
+    char *variant = malloc(length + 1);
+    size_t prefix = qualifier - source;
+    memcpy(variant, source, prefix);
+    strcpy(variant + prefix, precision);
+    strcat(variant, end);
+
+    for (int i = 0; i < variantCount; i++) {
+        if (strcmp(variants[i], variant) == 0) {
+            free(variant);
+            return variants[i];
+        }
+    }
+
+    if (variantCount == MAX_VARIANTS) {
+        free(variant);
+        return source;
+    }
+    variants[variantCount++] = variant;
+    return variant;
+}
+
+GLuint buildProgram(const char *name, const char *vertexSource, const char *fragmentSource) {
+    if (!binariesChecked) {
+        checkBinarySupport();
+    }
+
+    char variantName[128];
+    if (fragmentPrecision) {
+        const char *variant = precisionVariant(fragmentSource, fragmentPrecision);
+        if (variant != fragmentSource) {
+            snprintf(variantName, sizeof(variantName), "%s@%s", name, fragmentPrecision);
+            name = variantName;
+            fragmentSource = variant;
+        }
+    }
+
+    recordProgram(name, vertexSource, fragmentSource);
+
+    uint64_t key = 0;
+    if (cacheDir) {
+        key = hashString(0xcbf29ce484222325ULL, vertexSource);
+        key = hashString(key, fragmentSource);
+        key = hashString(key, (const char *)glGetString(GL_RENDERER));
+        key = hashString(key, (const char *)glGetString(GL_VERSION));
+
+        GLuint program = loadBinary(key);
+        if (program) {
+            loadProgramReflection(program);
+            return program;
+        }
+    }
+
+    int vertexCached, fragmentCached;
+    GLuint vertexShader = compileShader(name, GL_VERTEX_SHADER, vertexSource, &vertexCached);
+    GLuint fragmentShader = compileShader(name, GL_FRAGMENT_SHADER, fragmentSource, &fragmentCached);
+
+    GLuint program = glCreateProgram();
+    if (vertexShader) glAttachShader(program, vertexShader);
+    if (fragmentShader) glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    // Shaders that did not fit in the cache are only flagged while attached
+    if (vertexShader && !vertexCached) glDeleteShader(vertexShader);
+    if (fragmentShader && !fragmentCached) glDeleteShader(fragmentShader);
+
+    if (!checkLinked(name, program)) {
+        return program;
+    }
+
+    // Shared shaders stay alive in the cache; detach so the program does not pin them
+    if (vertexShader) glDetachShader(program, vertexShader);
+    if (fragmentShader) glDetachShader(program, fragmentShader);
+
+    if (cacheDir) {
+        storeBinary(key, program);
+    }
+
+    loadProgramReflection(program);
+    return program;
+}
+
+GLuint linkUncachedProgram(const char *name, const char *vertexSource, const char *fragmentSource,
+                           const char *const *attribNames) {
+    GLuint vertexShader = compileSource(name, GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = compileSource(name, GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) glDeleteShader(vertexShader);
+        if (fragmentShader) glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    for (GLuint i = 0; attribNames && attribNames[i]; i++) {
+        glBindAttribLocation(program, i, attribNames[i]);
+    }
+    glLinkProgram(program);
+
+    // Only flagged for deletion until the program goes
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    if (!checkLinked(name, program)) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void releaseShaderCache() {
+    for (int i = 0; i < shaderCount; i++) {
+        glDeleteShader(shaders[i].shader);
+    }
+    shaderCount = 0;
+    binariesChecked = 0;
+}
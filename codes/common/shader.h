@@ -0,0 +1,56 @@
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <GLES2/gl2.h>
+
+// Compiles and links a program, checking both steps and printing the info log
+// on failure (the program is still returned so the suite keeps running).
+//
+// Shader objects are compiled once per context and shared between programs.
+// When the driver supports GL_OES_get_program_binary, linked programs are also
+// stored in $SHADER_CACHE_DIR (default .shader_cache; empty disables it), keyed
+// by a hash of both sources and the GL renderer/version, and reloaded on later
+// runs. A binary the driver rejects is simply rebuilt from source.
+GLuint buildProgram(const char *name, const char *vertexSource, const char *fragmentSource);
+
+// Compiles and links a throwaway program outside both caches and without the
+// precision override, binding attribNames[i] (NULL-terminated) to location i.
+// Prints the compile or link log and returns 0 on failure. Nothing is recorded
+// for reflection, so use the GL queries or the bound locations.
+GLuint linkUncachedProgram(const char *name, const char *vertexSource, const char *fragmentSource,
+                           const char *const *attribNames);
+
+// Uniform and attribute locations of programs made by buildProgram(), read
+// once with glGetActiveUniform/glGetActiveAttrib when the program is linked.
+// Lookups are hash probes with no GL call; unknown names return -1 like
+// glGetUniformLocation. Other programs fall back to the GL queries.
+GLint programUniform(GLuint program, const char *name);
+GLint programAttrib(GLuint program, const char *name);
+
+// Fills the reflection table; buildProgram() calls it after every link.
+void loadProgramReflection(GLuint program);
+
+// Every distinct program passed to buildProgram(), in first-use order, so the
+// shader benchmark can rebuild them. Sources must outlive the run, which the
+// string literals in the suites do.
+struct ShaderRecord {
+    const char *name;
+    const char *vertexSource;
+    const char *fragmentSource;
+};
+
+int shaderRecordCount();
+const struct ShaderRecord *shaderRecord(int index);
+
+// Overrides the default float precision of every fragment shader built from
+// now on: "precision mediump float;" is rewritten to the given qualifier
+// ("lowp", "mediump" or "highp") and the program name gets "@<qualifier>"
+// appended. NULL builds the sources as written. runSuite() sets it only around
+// a suite's init(), so shaders that need a fixed precision are never rewritten.
+void setShaderPrecision(const char *precision);
+const char *shaderPrecision();
+
+// Deletes the shared shader objects. Call before destroying the context.
+void releaseShaderCache();
+
+#endif
@@ -0,0 +1,145 @@
+#include "shaderBench.h"
+#include "shader.h"
+#include "timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct BenchShader {
+    const char *label;      // first program that used it
+    GLenum type;
+    const char *source;
+    double *times;
+    GLint logSize;
+    int failed;
+};
+
+static struct BenchShader *findShader(struct BenchShader *shaders, int count, GLenum type, const char *source) {
+    for (int i = 0; i < count; i++) {
+        if (shaders[i].type == type && strcmp(shaders[i].source, source) == 0) {
+            return &shaders[i];
+        }
+    }
+    return NULL;
+}
+
+// Compile time includes the status query, since drivers may defer the actual
+// compilation until somebody asks for the result.
+static GLuint timedCompile(GLenum type, const char *source, double *elapsed, GLint *compiled, GLint *logSize) {
+    double start = timeNowMs();
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, compiled);
+    *elapsed = timeNowMs() - start;
+
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, logSize);
+    return shader;
+}
+
+static void printRow(const char *label, const char *kind, double *times, int count, GLint logSize, int failed) {
+    sortTimings(times, count);
+    printf("  %-44s %-4s %8.3f %8.3f %8.3f %8.3f %6d%s\n", label, kind, times[0],
+           timingPercentile(times, count, 0.50), timingPercentile(times, count, 0.95),
+           timingPercentile(times, count, 0.99), logSize, failed ? "  FAILED" : "");
+}
+
+int runShaderBench(int iterations) {
+    int programCount = shaderRecordCount();
+    if (iterations <= 0 || programCount == 0) {
+        return 1;
+    }
+
+    // Distinct shaders, labelled by the first program that used them
+    struct BenchShader *shaders = calloc(programCount * 2, sizeof(struct BenchShader));
+    int shaderCount = 0;
+    int *vertexIndex = malloc(programCount * sizeof(int));
+    int *fragmentIndex = malloc(programCount * sizeof(int));
+
+    for (int p = 0; p < programCount; p++) {
+        const struct ShaderRecord *record = shaderRecord(p);
+        const char *sources[2] = {record->vertexSource, record->fragmentSource};
+        GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        int *indices[2] = {vertexIndex, fragmentIndex};
+
+        for (int s = 0; s < 2; s++) {
+            struct BenchShader *shader = findShader(shaders, shaderCount, types[s], sources[s]);
+            if (!shader) {
+                shader = &shaders[shaderCount++];
+                shader->label = record->name;
+                shader->type = types[s];
+                shader->source = sources[s];
+                shader->times = malloc(iterations * sizeof(double));
+            }
+            indices[s][p] = (int)(shader - shaders);
+        }
+    }
+
+    double *linkTimes = malloc((size_t)programCount * iterations * sizeof(double));
+    GLint *linkLogSizes = calloc(programCount, sizeof(GLint));
+    int *linkFailed = calloc(programCount, sizeof(int));
+    GLuint *compiledShaders = malloc(shaderCount * sizeof(GLuint));
+
+    for (int it = 0; it < iterations; it++) {
+        for (int s = 0; s < shaderCount; s++) {
+            GLint compiled = GL_FALSE;
+            compiledShaders[s] = timedCompile(shaders[s].type, shaders[s].source,
+                                              &shaders[s].times[it], &compiled, &shaders[s].logSize);
+            if (!compiled) shaders[s].failed = 1;
+        }
+
+        for (int p = 0; p < programCount; p++) {
+            double start = timeNowMs();
+            GLuint program = glCreateProgram();
+            glAttachShader(program, compiledShaders[vertexIndex[p]]);
+            glAttachShader(program, compiledShaders[fragmentIndex[p]]);
+            glLinkProgram(program);
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            linkTimes[(size_t)p * iterations + it] = timeNowMs() - start;
+
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &linkLogSizes[p]);
+            if (!linked) linkFailed[p] = 1;
+            glDeleteProgram(program);
+        }
+
+        for (int s = 0; s < shaderCount; s++) {
+            glDeleteShader(compiledShaders[s]);
+        }
+    }
+
+    int failures = 0;
+
+    printf("Shader compile latency, %d iterations (ms)\n", iterations);
+    printf("  %-44s %-4s %8s %8s %8s %8s %6s\n", "first used by", "type", "min", "median", "p95", "p99", "log");
+    for (int s = 0; s < shaderCount; s++) {
+        printRow(shaders[s].label, shaders[s].type == GL_VERTEX_SHADER ? "VS" : "FS",
+                 shaders[s].times, iterations, shaders[s].logSize, shaders[s].failed);
+        failures += shaders[s].failed;
+    }
+
+    printf("Program link latency, %d iterations (ms)\n", iterations);
+    printf("  %-44s %-4s %8s %8s %8s %8s %6s\n", "program", "", "min", "median", "p95", "p99", "log");
+    for (int p = 0; p < programCount; p++) {
+        printRow(shaderRecord(p)->name, "", linkTimes + (size_t)p * iterations, iterations,
+                 linkLogSizes[p], linkFailed[p]);
+        failures += linkFailed[p];
+    }
+
+    if (failures) {
+        printf("%d shaders or programs FAILED\n", failures);
+    }
+
+    for (int s = 0; s < shaderCount; s++) {
+        free(shaders[s].times);
+    }
+    free(shaders);
+    free(vertexIndex);
+    free(fragmentIndex);
+    free(linkTimes);
+    free(linkLogSizes);
+    free(linkFailed);
+    free(compiledShaders);
+    return failures == 0;
+}
@@ -0,0 +1,10 @@
+#ifndef SHADER_BENCH_H
+#define SHADER_BENCH_H
+
+// Recompiles every distinct shader and relinks every program recorded by
+// buildProgram() iterations times, bypassing both shader caches, and prints
+// compile/link latency percentiles and info-log sizes. Returns 0 if any
+// shader failed to compile or any program failed to link.
+int runShaderBench(int iterations);
+
+#endif
@@ -0,0 +1,166 @@
+#include "stencilReadback.h"
+#include "glState.h"
+#include "shader.h"
+
+#include <GLES2/gl2.h>
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec2 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+    "}";
+
+static const char *fragmentSource =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "uniform float uBit;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(0.0, 0.0, 0.0, uBit);\n"
+    "}";
+
+static GLuint program;
+static GLuint quad;
+static GLint bitUniform;
+static GLint positionAttrib;
+
+// The fixed-function state the passes change, read back with glGet
+struct SavedState {
+    GLint viewport[4], scissorBox[4];
+    GLboolean colorMask[4];
+    GLfloat clearColor[4];
+    GLint blendSrcRGB, blendDstRGB, blendSrcAlpha, blendDstAlpha;
+    GLint blendEquationRGB, blendEquationAlpha;
+    GLboolean blend, depthTest, scissorTest, stencilTest, cullFace, dither;
+    GLint stencil[2][7];    // func, ref, value mask, fail, depth fail, depth pass, write mask
+};
+
+static const GLenum stencilQueries[2][7] = {
+    {GL_STENCIL_FUNC, GL_STENCIL_REF, GL_STENCIL_VALUE_MASK, GL_STENCIL_FAIL,
+     GL_STENCIL_PASS_DEPTH_FAIL, GL_STENCIL_PASS_DEPTH_PASS, GL_STENCIL_WRITEMASK},
+    {GL_STENCIL_BACK_FUNC, GL_STENCIL_BACK_REF, GL_STENCIL_BACK_VALUE_MASK, GL_STENCIL_BACK_FAIL,
+     GL_STENCIL_BACK_PASS_DEPTH_FAIL, GL_STENCIL_BACK_PASS_DEPTH_PASS, GL_STENCIL_BACK_WRITEMASK},
+};
+
+static void saveState(struct SavedState *state) {
+    glGetIntegerv(GL_VIEWPORT, state->viewport);
+    glGetIntegerv(GL_SCISSOR_BOX, state->scissorBox);
+    glGetBooleanv(GL_COLOR_WRITEMASK, state->colorMask);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, state->clearColor);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &state->blendSrcRGB);
+    glGetIntegerv(GL_BLEND_DST_RGB, &state->blendDstRGB);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &state->blendSrcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &state->blendDstAlpha);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &state->blendEquationRGB);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &state->blendEquationAlpha);
+    state->blend = glIsEnabled(GL_BLEND);
+    state->depthTest = glIsEnabled(GL_DEPTH_TEST);
+    state->scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    state->stencilTest = glIsEnabled(GL_STENCIL_TEST);
+    state->cullFace = glIsEnabled(GL_CULL_FACE);
+    state->dither = glIsEnabled(GL_DITHER);
+    for (int face = 0; face < 2; face++) {
+        for (int i = 0; i < 7; i++) {
+            glGetIntegerv(stencilQueries[face][i], &state->stencil[face][i]);
+        }
+    }
+}
+
+static void setEnabled(GLenum cap, GLboolean enabled) {
+    if (enabled) {
+        glEnable(cap);
+    } else {
+        glDisable(cap);
+    }
+}
+
+static void restoreState(const struct SavedState *state) {
+    glViewport(state->viewport[0], state->viewport[1], state->viewport[2], state->viewport[3]);
+    glScissor(state->scissorBox[0], state->scissorBox[1], state->scissorBox[2], state->scissorBox[3]);
+    glColorMask(state->colorMask[0], state->colorMask[1], state->colorMask[2], state->colorMask[3]);
+    glClearColor(state->clearColor[0], state->clearColor[1], state->clearColor[2], state->clearColor[3]);
+    glBlendFuncSeparate(state->blendSrcRGB, state->blendDstRGB, state->blendSrcAlpha, state->blendDstAlpha);
+    glBlendEquationSeparate(state->blendEquationRGB, state->blendEquationAlpha);
+    setEnabled(GL_BLEND, state->blend);
+    setEnabled(GL_DEPTH_TEST, state->depthTest);
+    setEnabled(GL_SCISSOR_TEST, state->scissorTest);
+    setEnabled(GL_STENCIL_TEST, state->stencilTest);
+    setEnabled(GL_CULL_FACE, state->cullFace);
+    setEnabled(GL_DITHER, state->dither);
+
+    GLenum faces[2] = {GL_FRONT, GL_BACK};
+    for (int face = 0; face < 2; face++) {
+        const GLint *s = state->stencil[face];
+        glStencilFuncSeparate(faces[face], s[0], s[1], (GLuint)s[2]);
+        glStencilOpSeparate(faces[face], s[3], s[4], s[5]);
+        glStencilMaskSeparate(faces[face], (GLuint)s[6]);
+    }
+}
+
+int stencilReadback(int x, int y, int width, int height, unsigned char *pixels) {
+    GLint alphaBits = 0, stencilBits = 0;
+    glGetIntegerv(GL_ALPHA_BITS, &alphaBits);
+    glGetIntegerv(GL_STENCIL_BITS, &stencilBits);
+    if (alphaBits < 8 || stencilBits < 8) {
+        return 0;
+    }
+
+    if (!program) {
+        program = buildProgram("stencilReadback", vertexSource, fragmentSource);
+        bitUniform = programUniform(program, "uBit");
+        positionAttrib = programAttrib(program, "aPosition");
+
+        float quadVertices[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+        glGenBuffers(1, &quad);
+        stateBindBuffer(GL_ARRAY_BUFFER, quad);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    }
+
+    struct SavedState saved;
+    saveState(&saved);
+
+    // Alpha only: the color stays as drawn
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // The bit values are exact in 8 bits and never sum past 255, so the
+    // blended alpha is exactly the stencil value
+    glViewport(x, y, width, height);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DITHER);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glEnable(GL_STENCIL_TEST);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glStencilMask(0);
+
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, quad);
+    stateVertexAttribPointer(positionAttrib, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(positionAttrib);
+
+    for (int bit = 0; bit < 8; bit++) {
+        glStencilFunc(GL_EQUAL, 1 << bit, 1 << bit);
+        glUniform1f(bitUniform, (1 << bit) / 255.0f);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    restoreState(&saved);
+    return 1;
+}
+
+void stencilReadbackRelease() {
+    if (program) {
+        glDeleteProgram(program);
+        glDeleteBuffers(1, &quad);
+        program = 0;
+        quad = 0;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef STENCIL_READBACK_H
+#define STENCIL_READBACK_H
+
+// Reads the stencil buffer back, which glReadPixels cannot do in GLES2. The
+// alpha channel of the rectangle is cleared, then eight passes, one per bit
+// b, draw it with glStencilFunc(GL_EQUAL, 1 << b, 1 << b) and additive
+// blending of (1 << b) / 255 into alpha only. Alpha then holds the 8-bit
+// stencil value and a single glReadPixels returns it: eight draws instead of
+// one GL_EQUAL pass per value.
+//
+// pixels receives width * height RGBA values, rows bottom to top like
+// glReadPixels: red, green and blue are the color buffer, alpha the stencil.
+// The color buffer's alpha is left holding the stencil for the caller to
+// restore; every other piece of GL state the passes touch is put back.
+// Returns 0 if the bound framebuffer has fewer than 8 alpha or stencil bits.
+int stencilReadback(int x, int y, int width, int height, unsigned char *pixels);
+
+// Deletes the program and buffer made on first use. Call before the context
+// is destroyed.
+void stencilReadbackRelease();
+
+#endif
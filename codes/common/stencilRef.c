@@ -0,0 +1,183 @@
+#include "stencilRef.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// GL clamps the reference to the range of the 8-bit stencil buffer
+static int clampRef(GLint ref) {
+    return ref < 0 ? 0 : ref > 255 ? 255 : ref;
+}
+
+void stencilFaceDefaults(struct StencilFace *face) {
+    face->func = GL_ALWAYS;
+    face->ref = 0;
+    face->valueMask = 0xFF;
+    face->sfail = face->dpfail = face->dppass = GL_KEEP;
+    face->writeMask = 0xFF;
+}
+
+int stencilRefTest(const struct StencilFace *face, unsigned char stencil) {
+    int ref = clampRef(face->ref) & face->valueMask;
+    int value = stencil & face->valueMask;
+
+    switch (face->func) {
+    case GL_NEVER: return 0;
+    case GL_LESS: return ref < value;
+    case GL_LEQUAL: return ref <= value;
+    case GL_GREATER: return ref > value;
+    case GL_GEQUAL: return ref >= value;
+    case GL_EQUAL: return ref == value;
+    case GL_NOTEQUAL: return ref != value;
+    default: return 1;
+    }
+}
+
+unsigned char stencilRefOp(GLenum op, unsigned char stencil, GLint ref) {
+    switch (op) {
+    case GL_ZERO: return 0;
+    case GL_REPLACE: return (unsigned char)clampRef(ref);
+    case GL_INCR: return stencil == 255 ? 255 : stencil + 1;
+    case GL_DECR: return stencil == 0 ? 0 : stencil - 1;
+    case GL_INVERT: return (unsigned char)~stencil;
+    case GL_INCR_WRAP: return (unsigned char)(stencil + 1);
+    case GL_DECR_WRAP: return (unsigned char)(stencil - 1);
+    default: return stencil;
+    }
+}
+
+#if defined(__AVX2__)
+// Unsigned byte compares are signed compares with the top bit flipped
+static __m256i compare256(GLenum func, __m256i value, __m256i ref) {
+    const __m256i bias = _mm256_set1_epi8((char)0x80);
+    const __m256i ones = _mm256_set1_epi8((char)0xFF);
+    __m256i v = _mm256_xor_si256(value, bias), r = _mm256_xor_si256(ref, bias);
+
+    switch (func) {
+    case GL_NEVER: return _mm256_setzero_si256();
+    case GL_LESS: return _mm256_cmpgt_epi8(v, r);
+    case GL_LEQUAL: return _mm256_xor_si256(_mm256_cmpgt_epi8(r, v), ones);
+    case GL_GREATER: return _mm256_cmpgt_epi8(r, v);
+    case GL_GEQUAL: return _mm256_xor_si256(_mm256_cmpgt_epi8(v, r), ones);
+    case GL_EQUAL: return _mm256_cmpeq_epi8(value, ref);
+    case GL_NOTEQUAL: return _mm256_xor_si256(_mm256_cmpeq_epi8(value, ref), ones);
+    default: return ones;
+    }
+}
+
+static __m256i op256(GLenum op, __m256i stencil, __m256i ref) {
+    const __m256i one = _mm256_set1_epi8(1);
+
+    switch (op) {
+    case GL_ZERO: return _mm256_setzero_si256();
+    case GL_REPLACE: return ref;
+    case GL_INCR: return _mm256_adds_epu8(stencil, one);
+    case GL_DECR: return _mm256_subs_epu8(stencil, one);
+    case GL_INVERT: return _mm256_xor_si256(stencil, _mm256_set1_epi8((char)0xFF));
+    case GL_INCR_WRAP: return _mm256_add_epi8(stencil, one);
+    case GL_DECR_WRAP: return _mm256_sub_epi8(stencil, one);
+    default: return stencil;
+    }
+}
+
+static __m256i select256(__m256i mask, __m256i a, __m256i b) {
+    return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+}
+#endif
+
+#if defined(__SSE2__)
+static __m128i compare128(GLenum func, __m128i value, __m128i ref) {
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    __m128i v = _mm_xor_si128(value, bias), r = _mm_xor_si128(ref, bias);
+
+    switch (func) {
+    case GL_NEVER: return _mm_setzero_si128();
+    case GL_LESS: return _mm_cmpgt_epi8(v, r);
+    case GL_LEQUAL: return _mm_xor_si128(_mm_cmpgt_epi8(r, v), ones);
+    case GL_GREATER: return _mm_cmpgt_epi8(r, v);
+    case GL_GEQUAL: return _mm_xor_si128(_mm_cmpgt_epi8(v, r), ones);
+    case GL_EQUAL: return _mm_cmpeq_epi8(value, ref);
+    case GL_NOTEQUAL: return _mm_xor_si128(_mm_cmpeq_epi8(value, ref), ones);
+    default: return ones;
+    }
+}
+
+static __m128i op128(GLenum op, __m128i stencil, __m128i ref) {
+    const __m128i one = _mm_set1_epi8(1);
+
+    switch (op) {
+    case GL_ZERO: return _mm_setzero_si128();
+    case GL_REPLACE: return ref;
+    case GL_INCR: return _mm_adds_epu8(stencil, one);
+    case GL_DECR: return _mm_subs_epu8(stencil, one);
+    case GL_INVERT: return _mm_xor_si128(stencil, _mm_set1_epi8((char)0xFF));
+    case GL_INCR_WRAP: return _mm_add_epi8(stencil, one);
+    case GL_DECR_WRAP: return _mm_sub_epi8(stencil, one);
+    default: return stencil;
+    }
+}
+
+static __m128i select128(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+#endif
+
+void stencilRefSpan(const struct StencilFace *face, unsigned char *stencil,
+                    const unsigned char *depthPass, unsigned char *pass, int count) {
+    int ref = clampRef(face->ref);
+    int i = 0;
+
+#if defined(__AVX2__)
+    const __m256i ref32 = _mm256_set1_epi8((char)ref);
+    const __m256i valueMask32 = _mm256_set1_epi8((char)face->valueMask);
+    const __m256i maskedRef32 = _mm256_and_si256(ref32, valueMask32);
+    const __m256i writeMask32 = _mm256_set1_epi8((char)face->writeMask);
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(stencil + i));
+        __m256i passed = compare256(face->func, _mm256_and_si256(s, valueMask32), maskedRef32);
+        __m256i depth = depthPass ? _mm256_loadu_si256((const __m256i *)(depthPass + i))
+                                  : _mm256_set1_epi8((char)0xFF);
+
+        __m256i updated = select256(passed,
+                                    select256(depth, op256(face->dppass, s, ref32), op256(face->dpfail, s, ref32)),
+                                    op256(face->sfail, s, ref32));
+        _mm256_storeu_si256((__m256i *)(stencil + i), select256(writeMask32, updated, s));
+        _mm256_storeu_si256((__m256i *)(pass + i), _mm256_and_si256(passed, depth));
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i ref16 = _mm_set1_epi8((char)ref);
+    const __m128i valueMask16 = _mm_set1_epi8((char)face->valueMask);
+    const __m128i maskedRef16 = _mm_and_si128(ref16, valueMask16);
+    const __m128i writeMask16 = _mm_set1_epi8((char)face->writeMask);
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(stencil + i));
+        __m128i passed = compare128(face->func, _mm_and_si128(s, valueMask16), maskedRef16);
+        __m128i depth = depthPass ? _mm_loadu_si128((const __m128i *)(depthPass + i))
+                                  : _mm_set1_epi8((char)0xFF);
+
+        __m128i updated = select128(passed,
+                                    select128(depth, op128(face->dppass, s, ref16), op128(face->dpfail, s, ref16)),
+                                    op128(face->sfail, s, ref16));
+        _mm_storeu_si128((__m128i *)(stencil + i), select128(writeMask16, updated, s));
+        _mm_storeu_si128((__m128i *)(pass + i), _mm_and_si128(passed, depth));
+    }
+#endif
+
+    for (; i < count; i++) {
+        int passed = stencilRefTest(face, stencil[i]);
+        int depth = depthPass ? depthPass[i] != 0 : 1;
+        GLenum op = !passed ? face->sfail : depth ? face->dppass : face->dpfail;
+        unsigned char updated = stencilRefOp(op, stencil[i], ref);
+
+        stencil[i] = (unsigned char)((stencil[i] & ~face->writeMask) | (updated & face->writeMask));
+        pass[i] = passed && depth ? 0xFF : 0;
+    }
+}
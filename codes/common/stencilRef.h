@@ -0,0 +1,34 @@
+#ifndef STENCIL_REF_H
+#define STENCIL_REF_H
+
+#include <GLES2/gl2.h>
+
+// Software model of the GLES2 stencil stage on an 8-bit stencil plane: all 8
+// compare functions and all 8 operations, with reference, value mask and write
+// mask. Spans are processed 32 pixels at a time with AVX2, 16 with SSE2.
+
+// The stencil state of one face, as set by glStencilFuncSeparate,
+// glStencilOpSeparate and glStencilMaskSeparate.
+struct StencilFace {
+    GLenum func;
+    GLint ref;
+    GLuint valueMask;
+    GLenum sfail, dpfail, dppass;
+    GLuint writeMask;
+};
+
+// The initial GL state: GL_ALWAYS, ref 0, all ones masks, GL_KEEP everywhere.
+void stencilFaceDefaults(struct StencilFace *face);
+
+// Tests and updates count stencil values of one span drawn with face's state.
+// depthPass is 0xFF per pixel where the depth test passed (NULL: everywhere).
+// pass receives 0xFF where the fragment survives both tests, 0 elsewhere.
+void stencilRefSpan(const struct StencilFace *face, unsigned char *stencil,
+                    const unsigned char *depthPass, unsigned char *pass, int count);
+
+// Whether the stencil test passes for one value, and the value an operation
+// leaves behind; the scalar definitions the span kernel is checked against.
+int stencilRefTest(const struct StencilFace *face, unsigned char stencil);
+unsigned char stencilRefOp(GLenum op, unsigned char stencil, GLint ref);
+
+#endif
@@ -0,0 +1,427 @@
+#include "stencilSweep.h"
+#include "arrayCount.h"
+#include "glState.h"
+#include "platform.h"
+#include "shader.h"
+#include "stencilReadback.h"
+#include "stencilRef.h"
+#include "timing.h"
+
+#include <GLES2/gl2ext.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CELL_WIDTH 8
+#define CELL_HEIGHT 2
+#define MAX_REPORTED 10
+
+static const GLenum funcs[] = {
+    GL_NEVER, GL_LESS, GL_LEQUAL, GL_GREATER, GL_GEQUAL, GL_EQUAL, GL_NOTEQUAL, GL_ALWAYS,
+};
+
+static const GLenum ops[] = {
+    GL_KEEP, GL_ZERO, GL_REPLACE, GL_INCR, GL_DECR, GL_INVERT, GL_INCR_WRAP, GL_DECR_WRAP,
+};
+
+// -1 and 0x13A are out of range and must be clamped to 0 and 0xFF
+static const GLint refs[] = {0x00, 0x5A, 0xFF, -1, 0x13A};
+static const GLuint valueMasks[] = {0xFF, 0xF0, 0x0F, 0x00};
+static const GLuint writeMasks[] = {0xFF, 0x5A, 0x00};
+
+// Starting stencil of the columns of a cell: both ends, the 0x5A reference,
+// and values either side of the nibble and sign boundaries
+static const unsigned char probes[CELL_WIDTH] = {0x00, 0x01, 0x0F, 0x5A, 0x7F, 0x80, 0xA5, 0xFF};
+
+#define CONFIG_COUNT ((long)COUNT(funcs) * COUNT(ops) * COUNT(ops) * COUNT(ops) * COUNT(refs) * \
+                      COUNT(valueMasks) * COUNT(writeMasks) * 2)
+
+struct SweepConfig {
+    GLenum face;                   // GL_FRONT or GL_BACK
+    struct StencilFace state;
+};
+
+// The reference varies fastest and the face slowest. Drivers that compile
+// the stencil state into the fragment shader (llvmpipe does) then build each
+// variant once and reuse it for the neighbouring cells.
+static struct SweepConfig configAt(long index) {
+    struct SweepConfig config;
+    config.state.ref = refs[index % COUNT(refs)];
+    index /= COUNT(refs);
+    config.state.writeMask = writeMasks[index % COUNT(writeMasks)];
+    index /= COUNT(writeMasks);
+    config.state.valueMask = valueMasks[index % COUNT(valueMasks)];
+    index /= COUNT(valueMasks);
+    config.state.dppass = ops[index % COUNT(ops)];
+    index /= COUNT(ops);
+    config.state.dpfail = ops[index % COUNT(ops)];
+    index /= COUNT(ops);
+    config.state.sfail = ops[index % COUNT(ops)];
+    index /= COUNT(ops);
+    config.state.func = funcs[index % COUNT(funcs)];
+    index /= COUNT(funcs);
+    config.face = index ? GL_BACK : GL_FRONT;
+    return config;
+}
+
+static const char *enumName(GLenum value) {
+    switch (value) {
+    case GL_NEVER: return "NEVER";
+    case GL_LESS: return "LESS";
+    case GL_LEQUAL: return "LEQUAL";
+    case GL_GREATER: return "GREATER";
+    case GL_GEQUAL: return "GEQUAL";
+    case GL_EQUAL: return "EQUAL";
+    case GL_NOTEQUAL: return "NOTEQUAL";
+    case GL_ALWAYS: return "ALWAYS";
+    case GL_KEEP: return "KEEP";
+    case GL_ZERO: return "ZERO";
+    case GL_REPLACE: return "REPLACE";
+    case GL_INCR: return "INCR";
+    case GL_DECR: return "DECR";
+    case GL_INVERT: return "INVERT";
+    case GL_INCR_WRAP: return "INCR_WRAP";
+    case GL_DECR_WRAP: return "DECR_WRAP";
+    case GL_FRONT: return "front";
+    case GL_BACK: return "back";
+    default: return "?";
+    }
+}
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec3 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 1.0);\n"
+    "}";
+
+static const char *fragmentSource =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "uniform vec3 uColor;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(uColor, 1.0);\n"
+    "}";
+
+// Where each part of the geometry starts in the vertex buffer
+struct Geometry {
+    GLuint buffer;
+    int frontQuad, backQuad;     // the whole target at z = 0, both windings
+    int depthRows, depthRowCount;
+    int probeColumns[CELL_WIDTH], probeColumnCount;
+};
+
+struct Vertices {
+    float *data;
+    int count;
+};
+
+// A rectangle in pixels, as two triangles; edges on pixel boundaries leave
+// no center in doubt
+static void addRect(struct Vertices *vertices, int side, float x0, float y0, float x1, float y1,
+                    float z, int clockwise) {
+    float corners[6][2] = {{x0, y0}, {x1, y0}, {x0, y1}, {x1, y0}, {x1, y1}, {x0, y1}};
+    if (clockwise) {
+        float swap[2] = {corners[1][0], corners[1][1]};
+        corners[1][0] = corners[2][0], corners[1][1] = corners[2][1];
+        corners[2][0] = swap[0], corners[2][1] = swap[1];
+        swap[0] = corners[4][0], swap[1] = corners[4][1];
+        corners[4][0] = corners[5][0], corners[4][1] = corners[5][1];
+        corners[5][0] = swap[0], corners[5][1] = swap[1];
+    }
+
+    for (int i = 0; i < 6; i++) {
+        float *vertex = vertices->data + vertices->count * 3;
+        vertex[0] = corners[i][0] * 2.0f / side - 1.0f;
+        vertex[1] = corners[i][1] * 2.0f / side - 1.0f;
+        vertex[2] = z;
+        vertices->count++;
+    }
+}
+
+static struct Geometry createGeometry(int side) {
+    struct Geometry geometry;
+    int rows = side / CELL_HEIGHT, columns = side / CELL_WIDTH;
+    struct Vertices vertices;
+    vertices.data = malloc((size_t)(12 + rows * 6 + CELL_WIDTH * columns * 6) * 3 * sizeof(float));
+    vertices.count = 0;
+
+    geometry.frontQuad = vertices.count;
+    addRect(&vertices, side, 0, 0, side, side, 0.0f, 0);
+    geometry.backQuad = vertices.count;
+    addRect(&vertices, side, 0, 0, side, side, 0.0f, 1);
+
+    // The second row of every cell, at the near plane
+    geometry.depthRows = vertices.count;
+    for (int row = 0; row < rows; row++) {
+        addRect(&vertices, side, 0, row * CELL_HEIGHT + 1, side, row * CELL_HEIGHT + 2, -1.0f, 0);
+    }
+    geometry.depthRowCount = vertices.count - geometry.depthRows;
+
+    // Column c of every cell, drawn with probes[c] as the reference
+    for (int c = 0; c < CELL_WIDTH; c++) {
+        geometry.probeColumns[c] = vertices.count;
+        for (int column = 0; column < columns; column++) {
+            addRect(&vertices, side, column * CELL_WIDTH + c, 0, column * CELL_WIDTH + c + 1, side, 0.0f, 0);
+        }
+    }
+    geometry.probeColumnCount = columns * 6;
+
+    glGenBuffers(1, &geometry.buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, geometry.buffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.count * 3 * sizeof(float), vertices.data, GL_STATIC_DRAW);
+    free(vertices.data);
+    return geometry;
+}
+
+// Color, depth and stencil target like the platform's offscreen framebuffer
+static int createTarget(int side, GLuint *framebuffer, GLuint renderbuffers[3]) {
+    const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+
+    glGenFramebuffers(1, framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, *framebuffer);
+    glGenRenderbuffers(3, renderbuffers);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8_OES, side, side);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+
+    if (extensions && strstr(extensions, "GL_OES_packed_depth_stencil")) {
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8_OES, side, side);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    } else {
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, side, side);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[2]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, side, side);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[2]);
+    }
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Clears the target, writes each column's probe value into the stencil of
+// every cell and puts the second row of every cell at the near plane
+static void prepareBatch(const struct Geometry *geometry) {
+    glDisable(GL_SCISSOR_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glStencilMask(0xFF);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClearDepthf(1.0f);
+    glClearStencil(0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_STENCIL_TEST);
+    glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    for (int c = 0; c < CELL_WIDTH; c++) {
+        glStencilFunc(GL_ALWAYS, probes[c], 0xFF);
+        glDrawArrays(GL_TRIANGLES, geometry->probeColumns[c], geometry->probeColumnCount);
+    }
+
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_ALWAYS);
+    glDrawArrays(GL_TRIANGLES, geometry->depthRows, geometry->depthRowCount);
+}
+
+// The face a configuration is not drawn with keeps this state, which inverts
+// every stencil value it touches, so a face mix-up shows as a wrong result
+static void poisonFaces() {
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_INVERT, GL_INVERT, GL_INVERT);
+    glStencilMask(0xFF);
+}
+
+// One scissored draw per configuration at z = 0: the first row of a cell
+// passes GL_LESS against the cleared depth, the second fails. Fragments that
+// pass both tests write red.
+static void drawCells(const struct Geometry *geometry, GLint colorUniform, int side, long first, int count,
+                      long stride) {
+    int columns = side / CELL_WIDTH;
+
+    glColorMask(GL_TRUE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glUniform3f(colorUniform, 1.0f, 0.0f, 0.0f);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_STENCIL_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    poisonFaces();
+
+    GLenum face = GL_FRONT;
+    for (int cell = 0; cell < count; cell++) {
+        struct SweepConfig config = configAt((first + cell) * stride);
+        const struct StencilFace *state = &config.state;
+
+        if (config.face != face) {
+            face = config.face;
+            poisonFaces();
+        }
+
+        glScissor((cell % columns) * CELL_WIDTH, (cell / columns) * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT);
+        glStencilFuncSeparate(config.face, state->func, state->ref, state->valueMask);
+        glStencilOpSeparate(config.face, state->sfail, state->dpfail, state->dppass);
+        glStencilMaskSeparate(config.face, state->writeMask);
+        glDrawArrays(GL_TRIANGLES, config.face == GL_FRONT ? geometry->frontQuad : geometry->backQuad, 6);
+    }
+}
+
+static void reportFailure(const struct SweepConfig *config, int column, int row,
+                          const unsigned char *pixel, int expectedPass, int expectedStencil) {
+    const struct StencilFace *state = &config->state;
+    printf("  FAIL %s func %s ref %d mask 0x%02X ops %s/%s/%s write 0x%02X: from 0x%02X, depth %s: "
+           "pass %d stencil 0x%02X, expected pass %d stencil 0x%02X\n",
+           enumName(config->face), enumName(state->func), state->ref, state->valueMask,
+           enumName(state->sfail), enumName(state->dpfail), enumName(state->dppass), state->writeMask,
+           probes[column], row == 0 ? "pass" : "fail", pixel[0] > 127, pixel[3],
+           expectedPass, expectedStencil);
+}
+
+// Checks every cell of a batch against stencilRef; returns the failed configurations
+static long compareBatch(const unsigned char *pixels, int side, long first, int count, long stride,
+                         long reported) {
+    static const unsigned char depthPass[CELL_WIDTH] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    static const unsigned char depthFail[CELL_WIDTH] = {0};
+    int columns = side / CELL_WIDTH;
+    long failed = 0;
+
+    for (int cell = 0; cell < count; cell++) {
+        struct SweepConfig config = configAt((first + cell) * stride);
+        int cellFailed = 0;
+
+        for (int row = 0; row < CELL_HEIGHT && !cellFailed; row++) {
+            unsigned char stencil[CELL_WIDTH], pass[CELL_WIDTH];
+            memcpy(stencil, probes, CELL_WIDTH);
+            stencilRefSpan(&config.state, stencil, row == 0 ? depthPass : depthFail, pass, CELL_WIDTH);
+
+            int y = (cell / columns) * CELL_HEIGHT + row;
+            const unsigned char *line = pixels + ((size_t)y * side + (cell % columns) * CELL_WIDTH) * 4;
+            for (int c = 0; c < CELL_WIDTH; c++) {
+                const unsigned char *pixel = line + c * 4;
+                if ((pixel[0] > 127) != (pass[c] != 0) || pixel[3] != stencil[c]) {
+                    if (reported + failed < MAX_REPORTED) {
+                        reportFailure(&config, c, row, pixel, pass[c] != 0, stencil[c]);
+                    }
+                    cellFailed = 1;
+                    break;
+                }
+            }
+        }
+        failed += cellFailed;
+    }
+    return failed;
+}
+
+int runStencilSweep(int side, long limit) {
+    side = platformClampTargetSide(side);
+    side -= side % CELL_WIDTH;
+    if (side <= 0) {
+        return 1;
+    }
+
+    GLuint framebuffer, renderbuffers[3];
+    if (!createTarget(side, &framebuffer, renderbuffers)) {
+        printf("Stencil sweep: %dx%d color, depth and stencil target is incomplete, skipped\n", side, side);
+        glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(3, renderbuffers);
+        return 0;
+    }
+
+    GLuint program = buildProgram("stencilSweep", vertexSource, fragmentSource);
+    GLint colorUniform = programUniform(program, "uColor");
+    GLuint posAttrib = programAttrib(program, "aPosition");
+    struct Geometry geometry = createGeometry(side);
+
+    glViewport(0, 0, side, side);
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glDisable(GL_CULL_FACE);
+    glDepthRangef(0.0f, 1.0f);
+
+    // A limited run takes every stride-th configuration. Every table size is a
+    // product of 2, 3 and 5, so a stride prime to all three still reaches every
+    // value of every field.
+    long stride = 1, total = CONFIG_COUNT;
+    if (limit > 0 && limit < CONFIG_COUNT) {
+        stride = CONFIG_COUNT / limit;
+        while (stride > 1 && (stride % 2 == 0 || stride % 3 == 0 || stride % 5 == 0)) {
+            stride--;
+        }
+        total = limit;
+    }
+
+    int cellsPerBatch = (side / CELL_WIDTH) * (side / CELL_HEIGHT);
+    int batches = (int)((total + cellsPerBatch - 1) / cellsPerBatch);
+    unsigned char *pixels = malloc((size_t)side * side * 4);
+    double prepareMs = 0.0, cellsMs = 0.0, readMs = 0.0, compareMs = 0.0;
+    long failed = 0;
+
+    printf("Stencil sweep, %ld of %ld configurations in %d batches of up to %d %dx%d cells (%dx%d target)\n",
+           total, CONFIG_COUNT, batches, cellsPerBatch, CELL_WIDTH, CELL_HEIGHT, side, side);
+
+    for (long first = 0; first < total; first += cellsPerBatch) {
+        int count = total - first < cellsPerBatch ? (int)(total - first) : cellsPerBatch;
+
+        // The stencil readback draws with its own program and buffer
+        stateUseProgram(program);
+        stateBindBuffer(GL_ARRAY_BUFFER, geometry.buffer);
+        stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        stateEnableVertexAttribArray(posAttrib);
+
+        // Each phase is finished before the next starts, so its time is its own
+        double start = timeNowMs();
+        prepareBatch(&geometry);
+        glFinish();
+        double prepared = timeNowMs();
+        drawCells(&geometry, colorUniform, side, first, count, stride);
+        glFinish();
+        double drawn = timeNowMs();
+        if (!stencilReadback(0, 0, side, side, pixels)) {
+            printf("  the target has fewer than 8 alpha or stencil bits, stopped\n");
+            failed = total;
+            break;
+        }
+        double read = timeNowMs();
+        failed += compareBatch(pixels, side, first, count, stride, failed);
+        double compared = timeNowMs();
+
+        prepareMs += prepared - start;
+        cellsMs += drawn - prepared;
+        readMs += read - drawn;
+        compareMs += compared - read;
+    }
+
+    double totalMs = prepareMs + cellsMs + readMs + compareMs;
+    printf("  %ld/%ld configurations match stencilRef\n", total - failed, total);
+    printf("  %.1f ms: prepare %.1f, cells %.1f, stencil readback %.1f, compare %.1f "
+           "(%.0f configurations/s)\n", totalMs, prepareMs, cellsMs, readMs, compareMs,
+           total / (totalMs / 1000.0));
+
+    free(pixels);
+    stateDisableVertexAttribArray(posAttrib);
+    glDeleteBuffers(1, &geometry.buffer);
+    glDeleteProgram(program);
+    stencilReadbackRelease();
+
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glStencilMask(0xFF);
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(3, renderbuffers);
+    stateInvalidate();
+    return failed == 0;
+}
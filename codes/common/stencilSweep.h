@@ -0,0 +1,16 @@
+#ifndef STENCIL_SWEEP_H
+#define STENCIL_SWEEP_H
+
+// Checks the GPU's stencil stage against stencilRef over the whole state
+// space: compare func x sfail x dpfail x dppass x reference x value mask x
+// write mask x face, 491520 configurations. Each configuration gets an 8x2
+// scissored cell of a side x side offscreen target; the 8 columns start from
+// different stencil values and the second row fails the depth test. A batch
+// fills the target and draws every cell, then reads color and stencil back
+// together with stencilReadback(). Prints the failing configurations (the
+// first few) and the time per phase. A limit above 0 checks only that many
+// configurations, spread evenly over the whole space. Returns 0 if a
+// configuration failed or the target is incomplete.
+int runStencilSweep(int side, long limit);
+
+#endif
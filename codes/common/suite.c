@@ -0,0 +1,331 @@
+#include "suite.h"
+#include "accuracy.h"
+#include "aluBench.h"
+#include "curve.h"
+#include "depthCheck.h"
+#include "depthMatrix.h"
+#include "glState.h"
+#include "golden.h"
+#include "pipe.h"
+#include "shader.h"
+#include "shaderBench.h"
+#include "stencilSweep.h"
+#include "timing.h"
+#include "uberBench.h"
+#include "verdict.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int frameCount = 0;
+static int warmupCount = 0;
+static int shaderBenchIterations = 0;
+static int accuracySide = 0;
+static int aluChainLength = 0;
+static int uberBenchTests = 0;
+static int stencilSweepSide = 0;
+static long stencilSweepLimit = 0;
+static int depthCheckSide = 0;
+static int depthMatrixSide = 0;
+static int uberShader = 0;
+static int batchedCells = 0;
+static int precisionReport = 0;
+static const char *suitePrecision = NULL;   // --precision, for suite shaders only
+static double lastFinishMedian = 0.0;   // of the last timed run, in ms
+
+static const char *precisionNames[] = {"lowp", "mediump", "highp"};
+
+int suiteParseArgs(int argc, char **argv) {
+    platformParseArgs(argc, argv);
+
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int used = goldenParseArg(argv[i], value);
+        if (used == 0) {
+            used = curveParseArg(argv[i], value);
+        }
+        if (used == 0) {
+            used = pipeParseArg(argv[i], value);
+        }
+
+        if (used > 0) {
+            i += used - 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--shader-bench") == 0 && i + 1 < argc) {
+            shaderBenchIterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--accuracy") == 0 && i + 1 < argc) {
+            accuracySide = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--alu-bench") == 0 && i + 1 < argc) {
+            aluChainLength = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--uber-bench") == 0 && i + 1 < argc) {
+            uberBenchTests = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stencil-sweep") == 0 && i + 1 < argc) {
+            stencilSweepSide = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stencil-sweep-limit") == 0 && i + 1 < argc) {
+            stencilSweepLimit = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--depth-check") == 0 && i + 1 < argc) {
+            depthCheckSide = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--depth-matrix") == 0 && i + 1 < argc) {
+            depthMatrixSide = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--uber") == 0) {
+            uberShader = 1;
+        } else if (strcmp(argv[i], "--batched-cells") == 0) {
+            batchedCells = 1;
+        } else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+            suitePrecision = argv[++i];
+        } else if (strcmp(argv[i], "--precision-report") == 0) {
+            precisionReport = 1;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argv[kept] = NULL;
+
+    if (frameCount < 0) frameCount = 0;
+    if (warmupCount < 0) warmupCount = 0;
+    return kept;
+}
+
+// Result checks that run on every drawn frame, before it is swapped away
+static void checkFrame() {
+    goldenCheckFrame();
+    pipeCheckFrame();
+    verdictCheckFrame();
+}
+
+// Draws warmup + frameCount frames. CPU time covers draw() alone, finish time
+// runs until glFinish() returns, so it includes the GPU work of the frame.
+static void runTimedFrames(const struct Suite *suite) {
+    double *cpuTimes = malloc(frameCount * sizeof(double));
+    double *finishTimes = malloc(frameCount * sizeof(double));
+    int recorded = 0;
+    long stateIssued = 0, stateElided = 0;
+
+    for (int i = 0; i < warmupCount + frameCount; i++) {
+        // Only a window can be closed early; headless runs every frame.
+        if (!platformIsHeadless() && platformShouldClose()) {
+            break;
+        }
+
+        stateResetCounters();
+        double start = timeNowMs();
+        suite->draw();
+        double submitted = timeNowMs();
+        glFinish();
+        double finished = timeNowMs();
+
+        if (i >= warmupCount) {
+            cpuTimes[recorded] = submitted - start;
+            finishTimes[recorded] = finished - start;
+            recorded++;
+
+            struct StateCounters counters = stateCounters();
+            stateIssued += counters.issued;
+            stateElided += counters.elided;
+        }
+
+        checkFrame();
+        platformSwapBuffers();
+    }
+
+    printf("%s: %d frames (%d warmup)\n", suite->name, recorded, warmupCount);
+    printTimingStats("cpu", cpuTimes, recorded);
+    printTimingStats("finish", finishTimes, recorded);
+    lastFinishMedian = recorded > 0 ? timingPercentile(finishTimes, recorded, 0.5) : 0.0;
+    if (recorded > 0 && stateIssued + stateElided > 0) {
+        printf("  %-8s %ld issued, %ld elided per frame\n", "state",
+               stateIssued / recorded, stateElided / recorded);
+    }
+
+    free(cpuTimes);
+    free(finishTimes);
+}
+
+int suiteMain(const struct Suite *suite, int argc, char **argv) {
+    suiteParseArgs(argc, argv);
+
+    if (!platformInit(suite->title, *suite->width, *suite->height, suite->samples)) {
+        printf("Failed to create context\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int passed = precisionReport ? runPrecisionReport(&suite, 1) : runSuite(suite);
+    passed &= suiteShutdown();
+    return passed ? 0 : 1;
+}
+
+int suiteShutdown() {
+    int passed = 1;
+    if (shaderBenchIterations > 0) {
+        passed = runShaderBench(shaderBenchIterations);
+    }
+    if (accuracySide > 0) {
+        passed &= runAccuracy(accuracySide);
+    }
+    if (aluChainLength > 0) {
+        passed &= runAluBench(aluChainLength);
+    }
+    if (uberBenchTests > 0) {
+        passed &= runUberBench(uberBenchTests);
+    }
+    if (stencilSweepSide > 0) {
+        passed &= runStencilSweep(stencilSweepSide, stencilSweepLimit);
+    }
+    if (depthCheckSide > 0) {
+        passed &= runDepthCheck(depthCheckSide);
+    }
+    if (depthMatrixSide > 0) {
+        passed &= runDepthMatrix(depthMatrixSide);
+    }
+
+    releaseShaderCache();
+    platformTerminate();
+    printf("Program terminated.\n");
+    return passed;
+}
+
+int runSuite(const struct Suite *suite) {
+    platformResize(suite->title, *suite->width, *suite->height, suite->samples);
+    resetGLState();
+    stateInvalidate();
+    pipeBegin(suite);
+
+    // Suites build their programs in init(); the harness shaders built later
+    // (readbacks, benchmarks, the accuracy packer) keep the precision they ask for
+    setShaderPrecision(suitePrecision);
+    suite->init();
+    setShaderPrecision(NULL);
+
+    // init() binds with raw GL calls and the first frame must not trust the shadow
+    stateInvalidate();
+    goldenBegin(suite);
+    verdictBegin();
+
+    if (frameCount > 0) {
+        runTimedFrames(suite);
+    } else {
+        while (!platformShouldClose()) {
+            suite->draw();
+            checkFrame();
+
+            // Swap buffers and poll events
+            platformSwapBuffers();
+        }
+    }
+
+    int passed = goldenEnd();
+    passed &= pipeEnd();
+    passed &= verdictEnd(suite->name);
+    suite->cleanup();
+    return passed;
+}
+
+int suitePrecisionReport() {
+    return precisionReport;
+}
+
+int suiteUberShader() {
+    return uberShader;
+}
+
+int suiteBatchedCells() {
+    return batchedCells;
+}
+
+// Fill throughput counts every framebuffer pixel once per frame, which is
+// what the grid suites cover with their cells.
+int runPrecisionReport(const struct Suite **suites, int count) {
+    struct Row {
+        struct VerdictSummary verdict;
+        int passed;
+        double finishMs;
+    };
+
+    struct Row *rows = calloc(count * 3, sizeof(struct Row));
+    const char *savedPrecision = suitePrecision;
+    int savedFrames = frameCount, savedWarmup = warmupCount;
+    int passed = 1;
+
+    if (frameCount == 0) {
+        frameCount = 20;
+        warmupCount = 2;
+    }
+
+    for (int p = 0; p < 3; p++) {
+        suitePrecision = precisionNames[p];
+        for (int s = 0; s < count; s++) {
+            printf("== %s @%s\n", suites[s]->name, precisionNames[p]);
+            struct Row *row = &rows[s * 3 + p];
+            row->passed = runSuite(suites[s]);
+            row->verdict = verdictSummary();
+            row->finishMs = lastFinishMedian;
+        }
+    }
+
+    printf("Precision report, median of %d frames (%d warmup)\n", frameCount, warmupCount);
+    printf("  %-24s %-8s %8s %8s %10s %10s\n", "suite", "float", "passed", "max err", "finish ms", "Mpix/s");
+    for (int s = 0; s < count; s++) {
+        double pixels = (double)*suites[s]->width * *suites[s]->height;
+        for (int p = 0; p < 3; p++) {
+            struct Row *row = &rows[s * 3 + p];
+            char tests[16] = "-", error[16] = "-";
+            if (row->verdict.total > 0) {
+                snprintf(tests, sizeof(tests), "%d/%d", row->verdict.passed, row->verdict.total);
+            }
+            if (row->verdict.maxError >= 0) {
+                snprintf(error, sizeof(error), "%d", row->verdict.maxError);
+            }
+            printf("  %-24s %-8s %8s %8s %10.3f %10.1f\n", suites[s]->name, precisionNames[p], tests, error,
+                   row->finishMs, row->finishMs > 0.0 ? pixels / (row->finishMs * 1000.0) : 0.0);
+            passed &= row->passed;
+        }
+    }
+
+    suitePrecision = savedPrecision;
+    frameCount = savedFrames;
+    warmupCount = savedWarmup;
+    free(rows);
+    return passed;
+}
+
+void resetGLState() {
+    GLint attribCount = 0;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &attribCount);
+    for (int i = 0; i < attribCount; i++) {
+        glDisableVertexAttribArray(i);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+    glDisable(GL_SAMPLE_COVERAGE);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_DITHER);
+
+    glBlendFunc(GL_ONE, GL_ZERO);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glDepthRangef(0.0f, 1.0f);
+    glPolygonOffset(0.0f, 0.0f);
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glStencilMask(0xFF);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClearDepthf(1.0f);
+    glClearStencil(0);
+}
@@ -0,0 +1,69 @@
+#ifndef SUITE_H
+#define SUITE_H
+
+#include "platform.h"
+
+// One test program. init() creates its GL objects, draw() renders a frame and
+// cleanup() releases everything init() created. Each suite file builds into its
+// own program through suiteMain(), or, with -DSUITE_RUNNER, into the runner in
+// codes/runner which plays every suite back to back in a single context.
+struct Suite {
+    const char *name;
+    const char *title;
+    const char *reference;  // screenshot relative to codes/, for --golden
+    int *width;
+    int *height;
+    int samples;
+    void (*init)();
+    void (*draw)();
+    void (*cleanup)();
+};
+
+int suiteMain(const struct Suite *suite, int argc, char **argv);
+
+// Runs whichever of the shader benchmark (--shader-bench N), the builtin
+// accuracy harness (--accuracy SIDE), the ALU benchmark (--alu-bench K), the
+// uber-shader benchmark (--uber-bench N), the stencil state sweep
+// (--stencil-sweep SIDE, --stencil-sweep-limit N), the depth value check
+// (--depth-check SIDE) and the depth test matrix (--depth-matrix SIDE) were
+// requested, then destroys the context. Returns 0 if one of them found a broken
+// shader or a wrong result, or could not run.
+int suiteShutdown();
+
+// Consumes the platform flags, the benchmark flags (--frames N, --warmup M,
+// --shader-bench N, --accuracy SIDE, --alu-bench K, --uber-bench N,
+// --stencil-sweep SIDE, --stencil-sweep-limit N, --depth-check SIDE,
+// --depth-matrix SIDE), the uber flag (--uber), the precision flags
+// (--precision P, --precision-report), the golden-image flags (see golden.h),
+// the layout flag (--batched-cells), the curve flags (see curve.h) and the
+// reference flags (see pipe.h) and returns the new argc with those flags
+// removed from argv. With --frames, runSuite() draws warmup + N frames, prints
+// per-frame timings and returns.
+int suiteParseArgs(int argc, char **argv);
+
+// Runs one suite in the current context, resizing the framebuffer first.
+// Returns 0 if a golden-image or reference check failed.
+int runSuite(const struct Suite *suite);
+
+// With --precision-report the suites are run through runPrecisionReport()
+// instead of runSuite(): once per fragment float precision (lowp, mediump,
+// highp, see setShaderPrecision()), timed, followed by a table of verdicts,
+// worst expected-cell error and fill throughput per suite and precision.
+// --precision P alone runs the suites under one precision.
+int suitePrecisionReport();
+int runPrecisionReport(const struct Suite **suites, int count);
+
+// With --uber, suites that have one (commonFuncs) draw every cell with a single
+// uber-shader that selects the test through a uniform, instead of switching
+// to a specialized program per cell.
+int suiteUberShader();
+
+// With --batched-cells, suites that support it (commonFuncs) bake every cell
+// quad into one VBO with its cell index and let the vertex shader place it,
+// so the whole grid is one draw call with no viewport change per cell.
+int suiteBatchedCells();
+
+// Puts the GL state back to its defaults so one suite cannot leak state into the next.
+void resetGLState();
+
+#endif
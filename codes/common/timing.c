@@ -0,0 +1,41 @@
+#define _POSIX_C_SOURCE 199309L
+#include "timing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+double timeNowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void sortTimings(double *samples, int count) {
+    qsort(samples, count, sizeof(double), compareDoubles);
+}
+
+double timingPercentile(const double *sorted, int count, double p) {
+    int rank = (int)(p * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+void printTimingStats(const char *label, double *samples, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    sortTimings(samples, count);
+
+    printf("  %-8s min %8.3f ms  median %8.3f ms  p95 %8.3f ms  p99 %8.3f ms\n",
+           label, samples[0], timingPercentile(samples, count, 0.50),
+           timingPercentile(samples, count, 0.95), timingPercentile(samples, count, 0.99));
+}
@@ -0,0 +1,16 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+// Monotonic clock in milliseconds.
+double timeNowMs();
+
+// Sorts samples ascending; timingPercentile() expects sorted input.
+void sortTimings(double *samples, int count);
+
+// Nearest-rank percentile, p in [0, 1].
+double timingPercentile(const double *sorted, int count, double p);
+
+// Prints min/median/p95/p99 of count samples (milliseconds). Sorts samples in place.
+void printTimingStats(const char *label, double *samples, int count);
+
+#endif
@@ -0,0 +1,348 @@
+#include "uberBench.h"
+#include "glState.h"
+#include "glslGen.h"
+#include "platform.h"
+#include "shader.h"
+#include "timing.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_SIZE 1024
+#define BENCH_FRAMES 5
+#define FLOATS_PER_VERTEX 5
+
+// The commonFuncs builtins, each taking the cell's x in [0, 1] and a per-test
+// constant c in (0, 1). Test k uses step k % STEP_COUNT with its own c, so no
+// two tests compile to the same code.
+static const char *steps[] = {
+    "abs(x - %s)",
+    "sign(x - %s) * 0.5 + 0.5",
+    "floor(x * 4.0 + %s) * 0.25",
+    "ceil(x * 4.0 - %s) * 0.25",
+    "fract(x * 3.0 + %s)",
+    "mod(x + %s, 0.5) * 2.0",
+    "min(x, %s)",
+    "max(x, %s)",
+    "clamp(x, %s * 0.5, 0.5)",
+    "mix(x, %s, 0.5)",
+    "step(%s, x)",
+    "smoothstep(%s * 0.5, 1.0, x)",
+};
+
+#define STEP_COUNT (int)(sizeof(steps) / sizeof(steps[0]))
+
+static const int testCounts[] = {12, 100, 1000};
+
+#define TEST_COUNT_COUNT (int)(sizeof(testCounts) / sizeof(testCounts[0]))
+
+enum Mode { SPECIALIZED, UBER_UNIFORM, UBER_VERTEX, MODE_COUNT };
+
+static const char *modeNames[] = {"specialized", "uber uniform", "uber vertex id"};
+
+static const char *vertexSource =
+    "#version 100\n"
+    "attribute vec2 aPos;\n"
+    "attribute vec2 aUV;\n"
+    "attribute float aTest;\n"
+    "varying vec2 vUV;\n"
+    "varying float vTest;\n"
+    "void main() {\n"
+    "    vUV = aUV;\n"
+    "    vTest = aTest;\n"
+    "    gl_Position = vec4(aPos, 0.0, 1.0);\n"
+    "}";
+
+static const char *const attribNames[] = {"aPos", "aUV", "aTest", NULL};
+
+// Growing source buffer for the selection tree
+struct Text {
+    char *data;
+    size_t length, capacity;
+};
+
+static void appendf(struct Text *text, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int needed = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (text->length + needed + 1 > text->capacity) {
+        text->capacity = (text->length + needed + 1) * 2;
+        text->data = realloc(text->data, text->capacity);
+    }
+
+    va_start(args, format);
+    vsnprintf(text->data + text->length, needed + 1, format, args);
+    va_end(args);
+    text->length += needed;
+}
+
+static void appendStep(struct Text *text, int test) {
+    char constant[32];
+    // Golden-ratio sequence: well spread over (0, 1) for any test count
+    glslFloat(constant, 0.05f + 0.9f * (float)(test * 0.6180339887 - (long)(test * 0.6180339887)));
+    appendf(text, steps[test % STEP_COUNT], constant);
+}
+
+// Binary search over the test id, so every fragment takes log2(count)
+// branches rather than walking a chain of count comparisons
+static void appendTree(struct Text *text, int first, int last, int depth) {
+    if (last - first == 1) {
+        appendf(text, "%*sr = ", depth * 4, "");
+        appendStep(text, first);
+        appendf(text, ";\n");
+        return;
+    }
+
+    int middle = (first + last) / 2;
+    appendf(text, "%*sif (t < %d.5) {\n", depth * 4, "", middle - 1);
+    appendTree(text, first, middle, depth + 1);
+    appendf(text, "%*s} else {\n", depth * 4, "");
+    appendTree(text, middle, last, depth + 1);
+    appendf(text, "%*s}\n", depth * 4, "");
+}
+
+// test < 0 builds the uber shader, selecting on uTest or on the vTest varying
+static char *fragmentSource(int test, int count, int perVertex) {
+    struct Text text = {0};
+
+    appendf(&text,
+            "#version 100\n"
+            "precision mediump float;\n"
+            "uniform float uTest;\n"
+            "varying vec2 vUV;\n"
+            "varying float vTest;\n"
+            "void main() {\n"
+            "    float x = vUV.x;\n"
+            "    float r = 0.0;\n");
+
+    if (test >= 0) {
+        appendf(&text, "    r = ");
+        appendStep(&text, test);
+        appendf(&text, ";\n");
+    } else {
+        appendf(&text, "    float t = %s;\n", perVertex ? "vTest" : "uTest");
+        appendTree(&text, 0, count, 1);
+    }
+
+    appendf(&text,
+            "    gl_FragColor = vec4(r, vUV.y, 0.0, 1.0);\n"
+            "}");
+    return text.data;
+}
+
+// Cells tile the whole target whatever the test count, so every frame shades
+// the same fragments and only the switching and branching costs change.
+static GLuint createCells(int count) {
+    int side = 1;
+    while (side * side < count) side++;
+
+    float *vertices = malloc(count * 6 * FLOATS_PER_VERTEX * sizeof(float));
+    static const float corners[6][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 0}, {1, 1}, {0, 1}};
+
+    for (int test = 0; test < count; test++) {
+        int col = test % side, row = test / side;
+        for (int v = 0; v < 6; v++) {
+            float *vertex = vertices + (test * 6 + v) * FLOATS_PER_VERTEX;
+            vertex[0] = (col + corners[v][0]) * 2.0f / side - 1.0f;
+            vertex[1] = (row + corners[v][1]) * 2.0f / side - 1.0f;
+            vertex[2] = corners[v][0];
+            vertex[3] = corners[v][1];
+            vertex[4] = (float)test;
+        }
+    }
+
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    stateBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER, count * 6 * FLOATS_PER_VERTEX * sizeof(float), vertices, GL_STATIC_DRAW);
+    free(vertices);
+
+    for (int i = 0; i < 3; i++) {
+        stateVertexAttribPointer(i, i < 2 ? 2 : 1, GL_FLOAT, GL_FALSE, FLOATS_PER_VERTEX * sizeof(float),
+                                 (void*)(i * 2 * sizeof(float)));
+        stateEnableVertexAttribArray(i);
+    }
+    return buffer;
+}
+
+static void drawFrame(enum Mode mode, const GLuint *programs, int count, GLint testUniform) {
+    switch (mode) {
+    case SPECIALIZED:
+        for (int test = 0; test < count; test++) {
+            stateUseProgram(programs[test]);
+            glDrawArrays(GL_TRIANGLES, test * 6, 6);
+        }
+        break;
+    case UBER_UNIFORM:
+        stateUseProgram(programs[0]);
+        for (int test = 0; test < count; test++) {
+            glUniform1f(testUniform, (float)test);
+            glDrawArrays(GL_TRIANGLES, test * 6, 6);
+        }
+        break;
+    default:
+        stateUseProgram(programs[0]);
+        glDrawArrays(GL_TRIANGLES, 0, count * 6);
+        break;
+    }
+}
+
+// Median CPU submit and glFinish times of one frame, after a warmup frame
+// that also absorbs any compilation the driver deferred to the first draw.
+static void timeFrames(enum Mode mode, const GLuint *programs, int count, GLint testUniform,
+                       double *cpu, double *finish) {
+    double cpuTimes[BENCH_FRAMES], finishTimes[BENCH_FRAMES];
+
+    drawFrame(mode, programs, count, testUniform);
+    glFinish();
+
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        double start = timeNowMs();
+        drawFrame(mode, programs, count, testUniform);
+        double submitted = timeNowMs();
+        glFinish();
+        cpuTimes[i] = submitted - start;
+        finishTimes[i] = timeNowMs() - start;
+    }
+
+    sortTimings(cpuTimes, BENCH_FRAMES);
+    sortTimings(finishTimes, BENCH_FRAMES);
+    *cpu = timingPercentile(cpuTimes, BENCH_FRAMES, 0.5);
+    *finish = timingPercentile(finishTimes, BENCH_FRAMES, 0.5);
+}
+
+// Pixels whose channels differ by more than one step
+static int countDifferences(const unsigned char *a, const unsigned char *b) {
+    int differences = 0;
+    for (int i = 0; i < BENCH_SIZE * BENCH_SIZE; i++) {
+        for (int c = 0; c < 4; c++) {
+            if (abs(a[i * 4 + c] - b[i * 4 + c]) > 1) {
+                differences++;
+                break;
+            }
+        }
+    }
+    return differences;
+}
+
+// Runs every mode for one test count and prints its row
+static int benchCount(int count, unsigned char *reference, unsigned char *pixels) {
+    GLuint *programs = calloc(count, sizeof(GLuint));
+    GLuint uber[2];
+    double buildMs[2];
+    int failures = 0;
+
+    // Uncached: a thousand throwaway programs would overflow the shader cache
+    // and fill the binary cache on disk
+    double start = timeNowMs();
+    for (int test = 0; test < count && failures == 0; test++) {
+        char *source = fragmentSource(test, count, 0);
+        programs[test] = linkUncachedProgram("uberBench", vertexSource, source, attribNames);
+        free(source);
+        failures += programs[test] == 0;
+    }
+    buildMs[0] = timeNowMs() - start;
+
+    // Both uber variants are timed together and the build time halved
+    start = timeNowMs();
+    for (int i = 0; i < 2; i++) {
+        char *source = fragmentSource(-1, count, i);
+        uber[i] = linkUncachedProgram("uberBench.uber", vertexSource, source, attribNames);
+        free(source);
+        failures += uber[i] == 0;
+    }
+    buildMs[1] = (timeNowMs() - start) / 2.0;
+
+    printf("  %6d %10.1f %10.1f", count, buildMs[0], buildMs[1]);
+
+    if (failures) {
+        printf("  FAILED\n");
+    } else {
+        GLuint cells = createCells(count);
+
+        for (int mode = 0; mode < MODE_COUNT; mode++) {
+            const GLuint *modePrograms = mode == SPECIALIZED ? programs : &uber[mode == UBER_VERTEX];
+            GLint testUniform = glGetUniformLocation(modePrograms[0], "uTest");
+            double cpu, finish;
+
+            timeFrames(mode, modePrograms, count, testUniform, &cpu, &finish);
+            printf(" %9.2f %9.2f", cpu, finish);
+
+            glReadPixels(0, 0, BENCH_SIZE, BENCH_SIZE, GL_RGBA, GL_UNSIGNED_BYTE,
+                         mode == SPECIALIZED ? reference : pixels);
+            int differences = mode == SPECIALIZED ? 0 : countDifferences(reference, pixels);
+            if (differences) {
+                printf(" (%d px differ)", differences);
+                failures++;
+            }
+        }
+        printf("\n");
+
+        glDeleteBuffers(1, &cells);
+    }
+
+    for (int test = 0; test < count; test++) {
+        glDeleteProgram(programs[test]);
+    }
+    glDeleteProgram(uber[0]);
+    glDeleteProgram(uber[1]);
+    free(programs);
+    // The next count's programs may reuse these names
+    stateInvalidate();
+    return failures;
+}
+
+int runUberBench(int maxTests) {
+    if (maxTests <= 0) {
+        return 1;
+    }
+
+    GLuint texture, framebuffer;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, BENCH_SIZE, BENCH_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    glViewport(0, 0, BENCH_SIZE, BENCH_SIZE);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    stateInvalidate();
+
+    unsigned char *reference = malloc(BENCH_SIZE * BENCH_SIZE * 4);
+    unsigned char *pixels = malloc(BENCH_SIZE * BENCH_SIZE * 4);
+    int failures = 0;
+
+    printf("Uber-shader benchmark, %dx%d fragments split into one cell per test\n", BENCH_SIZE, BENCH_SIZE);
+    printf("  (build ms per program set; cpu submit / finish ms per frame, median of %d frames)\n", BENCH_FRAMES);
+    printf("  %6s %10s %10s", "tests", "build spec", "build uber");
+    for (int mode = 0; mode < MODE_COUNT; mode++) {
+        printf(" %19s", modeNames[mode]);
+    }
+    printf("\n");
+
+    for (int i = 0; i < TEST_COUNT_COUNT && testCounts[i] < maxTests; i++) {
+        failures += benchCount(testCounts[i], reference, pixels);
+    }
+    failures += benchCount(maxTests, reference, pixels);
+
+    free(reference);
+    free(pixels);
+    for (int i = 0; i < 3; i++) {
+        stateDisableVertexAttribArray(i);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, platformFramebuffer());
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+    stateInvalidate();
+    return failures == 0;
+}
@@ -0,0 +1,16 @@
+#ifndef UBER_BENCH_H
+#define UBER_BENCH_H
+
+// Compares three ways of drawing a grid of builtin tests over the same
+// 1024x1024 target, for 12, 100 and 1000 tests (capped at maxTests, which is
+// always included):
+//   specialized    - one program per test, glUseProgram before every cell
+//   uber uniform   - one program selecting the test from a uniform, set per cell
+//   uber vertex id - one program selecting the test from a per-vertex id, so
+//                    the whole grid is a single draw and the branch is per fragment
+// Prints build time and the median CPU submit and glFinish times per frame,
+// and checks that all three produce the same image. Returns 0 if a program
+// failed to build or the images differ.
+int runUberBench(int maxTests);
+
+#endif
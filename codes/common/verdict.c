@@ -0,0 +1,203 @@
+#include "verdict.h"
+
+#include <GLES2/gl2.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_CELLS 1024
+#define BLOCK_SIZE 3
+
+// Allowed difference between expected and read value, in 8-bit steps
+#define EXPECT_TOLERANCE 4
+
+enum CellState { CELL_UNCHECKED, CELL_PASS, CELL_FAIL, CELL_UNKNOWN };
+
+struct Cell {
+    const char *name;
+    int x, y, width, height;
+    float (*expected)(float u, float v);
+    float (*expectedData)(const void *data, float u, float v);
+    const void *data;
+    enum CellState state;
+    int maxError;           // worst block pixel of an expected cell, any frame
+};
+
+static struct Cell cells[MAX_CELLS];
+static int cellCount;       // cells seen in any frame
+static int frameCellCount;  // cells drawn in the current frame
+static struct VerdictSummary summary;
+
+static struct Cell *addCell(const char *name, int x, int y, int width, int height) {
+    if (frameCellCount >= MAX_CELLS) {
+        return NULL;
+    }
+
+    // Cells are identified by their draw order within the frame
+    struct Cell *cell = &cells[frameCellCount++];
+    cell->name = name;
+    cell->x = x;
+    cell->y = y;
+    cell->width = width;
+    cell->height = height;
+    cell->expected = NULL;
+    cell->expectedData = NULL;
+    cell->data = NULL;
+
+    if (frameCellCount > cellCount) {
+        cell->state = CELL_UNCHECKED;
+        cell->maxError = 0;
+        cellCount = frameCellCount;
+    }
+    return cell;
+}
+
+void cellViewportExpect(const char *name, int x, int y, int width, int height,
+                        float (*expected)(float u, float v)) {
+    glViewport(x, y, width, height);
+    struct Cell *cell = addCell(name, x, y, width, height);
+    if (cell) {
+        cell->expected = expected;
+    }
+}
+
+void cellViewportExpectData(const char *name, int x, int y, int width, int height,
+                            float (*expected)(const void *data, float u, float v), const void *data) {
+    glViewport(x, y, width, height);
+    cellRegionExpectData(name, x, y, width, height, expected, data);
+}
+
+void cellRegionExpectData(const char *name, int x, int y, int width, int height,
+                          float (*expected)(const void *data, float u, float v), const void *data) {
+    struct Cell *cell = addCell(name, x, y, width, height);
+    if (cell) {
+        cell->expectedData = expected;
+        cell->data = data;
+    }
+}
+
+static float expectedValue(const struct Cell *cell, float u, float v) {
+    return cell->expected ? cell->expected(u, v) : cell->expectedData(cell->data, u, v);
+}
+
+static int hasExpected(const struct Cell *cell) {
+    return cell->expected || cell->expectedData;
+}
+
+void cellViewport(const char *name, int x, int y, int width, int height) {
+    glViewport(x, y, width, height);
+    addCell(name, x, y, width, height);
+}
+
+void verdictBegin() {
+    cellCount = 0;
+    frameCellCount = 0;
+}
+
+static enum CellState classifyColor(const unsigned char *pixels) {
+    int green = 0, red = 0;
+
+    for (int i = 0; i < BLOCK_SIZE * BLOCK_SIZE; i++) {
+        const unsigned char *p = pixels + i * 4;
+        if (p[1] >= 128 && p[0] < 128 && p[2] < 128) green++;
+        else if (p[0] >= 128 && p[1] < 128 && p[2] < 128) red++;
+    }
+
+    if (green == BLOCK_SIZE * BLOCK_SIZE) return CELL_PASS;
+    if (red > 0) return CELL_FAIL;
+    return CELL_UNKNOWN;
+}
+
+// Compares every block pixel with the expected value at its center. Sampling
+// half a pixel either side as well keeps step-like functions from failing
+// when a discontinuity falls inside the pixel.
+static enum CellState classifyExpected(struct Cell *cell, int blockX, int blockY,
+                                       const unsigned char *pixels) {
+    enum CellState state = CELL_PASS;
+    float du = 0.5f / cell->width;
+    float dv = 0.5f / cell->height;
+
+    for (int j = 0; j < BLOCK_SIZE; j++) {
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            float u = (blockX + i + 0.5f - cell->x) / cell->width;
+            float v = (blockY + j + 0.5f - cell->y) / cell->height;
+            int value = pixels[(j * BLOCK_SIZE + i) * 4];
+            int best = 255;
+
+            for (int sv = -1; sv <= 1; sv++) {
+                for (int su = -1; su <= 1; su++) {
+                    int expected = (int)lroundf(expectedValue(cell, u + su * du, v + sv * dv) * 255.0f);
+                    int error = value > expected ? value - expected : expected - value;
+                    if (error < best) best = error;
+                }
+            }
+
+            if (best > cell->maxError) {
+                cell->maxError = best;
+            }
+            if (best > EXPECT_TOLERANCE) {
+                state = CELL_FAIL;
+            }
+        }
+    }
+    return state;
+}
+
+struct VerdictSummary verdictSummary() {
+    return summary;
+}
+
+void verdictCheckFrame() {
+    unsigned char pixels[BLOCK_SIZE * BLOCK_SIZE * 4];
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    for (int c = 0; c < frameCellCount; c++) {
+        struct Cell *cell = &cells[c];
+        int blockX = cell->x + (cell->width - BLOCK_SIZE) / 2;
+        int blockY = cell->y + (cell->height - BLOCK_SIZE) / 2;
+
+        glReadPixels(blockX, blockY, BLOCK_SIZE, BLOCK_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+        enum CellState state = hasExpected(cell) ? classifyExpected(cell, blockX, blockY, pixels)
+                                              : classifyColor(pixels);
+
+        // A cell keeps the worst state it had in any frame
+        if (state > cell->state) {
+            cell->state = state;
+        }
+    }
+
+    frameCellCount = 0;
+}
+
+int verdictEnd(const char *suiteName) {
+    static const char *labels[] = {"----", "PASS", "FAIL", "????"};
+    int passed = 0;
+    int maxError = -1;
+
+    summary.passed = 0;
+    summary.total = 0;
+    summary.maxError = -1;
+
+    if (cellCount == 0) {
+        return 1;
+    }
+
+    for (int c = 0; c < cellCount; c++) {
+        printf("  [%s] %s\n", labels[cells[c].state], cells[c].name);
+        if (cells[c].state == CELL_PASS) {
+            passed++;
+        }
+        if (hasExpected(&cells[c]) && cells[c].maxError > maxError) {
+            maxError = cells[c].maxError;
+        }
+    }
+    printf("%s: %d/%d tests passed\n", suiteName, passed, cellCount);
+
+    summary.passed = passed;
+    summary.total = cellCount;
+    summary.maxError = maxError;
+
+    return passed == cellCount;
+}
@@ -0,0 +1,43 @@
+#ifndef VERDICT_H
+#define VERDICT_H
+
+// Per-cell pass/fail for the suites that draw one test per viewport cell.
+// draw() calls cellViewport() instead of glViewport(); after the frame only a
+// small block at the center of each cell is read back and classified.
+
+// A cell whose shader paints green on success and red on failure.
+void cellViewport(const char *name, int x, int y, int width, int height);
+
+// A cell whose red channel should equal expected(u, v), where u and v run from
+// 0 to 1 across the cell like the usual full-viewport quad texture coordinates.
+void cellViewportExpect(const char *name, int x, int y, int width, int height,
+                        float (*expected)(float u, float v));
+
+// Same, for table-driven suites: expected() also receives the cell's table entry.
+void cellViewportExpectData(const char *name, int x, int y, int width, int height,
+                            float (*expected)(const void *data, float u, float v), const void *data);
+
+// Registers the cell without touching the viewport, for suites that place all
+// their cells in the vertex shader and draw the whole grid at once.
+void cellRegionExpectData(const char *name, int x, int y, int width, int height,
+                          float (*expected)(const void *data, float u, float v), const void *data);
+
+void verdictBegin();
+void verdictCheckFrame();
+
+// Prints the per-test table (if any cells were drawn) and returns 1 if every
+// cell passed in every frame.
+int verdictEnd(const char *suiteName);
+
+// Totals of the suite verdictEnd() last finished: cells that passed, cells
+// drawn, and the largest difference (in 8-bit steps) between an expected cell
+// and its CPU value, or -1 if the suite has no expected cells.
+struct VerdictSummary {
+    int passed;
+    int total;
+    int maxError;
+};
+
+struct VerdictSummary verdictSummary();
+
+#endif
@@ -1,61 +1,64 @@
-#include <GLFW/glfw3.h>
+#include "../common/curve.h"
+#include "../common/glState.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
 #include <GLES2/gl2.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-void init();
-void drawLine(GLuint programID, unsigned int VBO, int size, float color[3]);
-void drawAxis(GLuint program, unsigned int VBO, float color[3]);
-void draw();
+static void init();
+static void cleanup();
+static void createFan(struct Curve *fan, float length, float step);
+static void createPlot(struct Curve *curve, float (*f)(float), float xMin, float xMax);
+static void drawFan(GLuint program, const struct Curve *fan, float color[3]);
+static void drawAxis(GLuint program, unsigned int VBO, float color[3]);
+static void drawCurve(GLuint program, const struct Curve *curve, float color[3]);
+static void draw();
 
 static float navy[3] = {0.0f, 0.125f, 0.376f};
 static float yellow[3] = {1.0f, 0.835f, 0.0f};
 static float green[3] = {0.0f, 0.65f, 0.2f};
 
-static GLFWwindow *window;
 static GLuint basicProgram,tanProgram,arcTanProgram,arcSinArcCosProgram,sinCosRadianProgram;
-static unsigned int xAndYAxisVBO,lineVBO,graphLineVBO;
+static unsigned int xAndYAxisVBO;
+static struct Curve fan,tanCurve,arcSinCurve,arcCosCurve,arcTanCurve;
 
-static GLint decision,tanPosX,sinCosRadianAngle,arcPosX,arcTanPosX;
+static GLint decision;
 
 static int g_width = 1280, g_height = 720;
 
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "glsl angle & geometry", NULL, NULL);
-    if (window == NULL) {
-        printf("Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(-1);
-    }
-    glfwMakeContextCurrent(window);
-
-    init();
-
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-    }
+// CPU versions of what the plot shaders compute, used to place adaptive samples
+static float tanPlot(float x) { return tanf(x * 3.14159265359f); }
+static float arcSinPlot(float x) { return asinf(x) / 3.14159265359f; }
+static float arcCosPlot(float x) { return acosf(x) / 3.14159265359f; }
+static float arcTanPlot(float x) { return atanf(x) / 3.14159265359f; }
 
+static void cleanup() {
     glDeleteBuffers(1, &xAndYAxisVBO);
-    glDeleteBuffers(1, &lineVBO);
-    glDeleteBuffers(1, &graphLineVBO);
+    curveDestroy(&fan);
+    curveDestroy(&tanCurve);
+    curveDestroy(&arcSinCurve);
+    curveDestroy(&arcCosCurve);
+    curveDestroy(&arcTanCurve);
     glDeleteProgram(basicProgram);
     glDeleteProgram(sinCosRadianProgram);
     glDeleteProgram(tanProgram);
     glDeleteProgram(arcSinArcCosProgram);
     glDeleteProgram(arcTanProgram);
+}
+
+const struct Suite angleTrigonometrySuite = {
+    "angle&trigonometry", "glsl angle & geometry", "glsl-Functions/Angle&Trigonometry.png", &g_width, &g_height, 4, init, draw, cleanup
+};
 
-    glfwTerminate();
-    printf("Program terminated.\n");
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&angleTrigonometrySuite, argc, argv);
 }
+#endif
 
-void init() {
+static void init() {
 
     const char * BasicVS = "#version 100\n"
                            "attribute vec3 aPos;\n"
@@ -72,9 +75,9 @@ void init() {
 
     const char *SinCosRadianVS = "#version 100\n"
                                  "attribute vec3 aPos;\n"
-                                 "uniform float uAngle;\n"
+                                 "attribute float aAngle;\n"
                                  "void main() {\n"
-                                 "    float rad = radians(uAngle);\n"
+                                 "    float rad = radians(aAngle);\n"
                                  "    float y = aPos.x * sin(rad);\n"
                                  "    float x = aPos.x * cos(rad);\n"
                                  "    gl_Position = vec4(x, y, aPos.z, 1.0);\n"
@@ -119,67 +122,12 @@ void init() {
                                  "    gl_Position = vec4(newX, y, aPos.z, 1.0);\n"
                                  "}";
 
-    GLuint basicVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(basicVShader, 1, &BasicVS, NULL);
-    glCompileShader(basicVShader);
-
-    GLuint basicFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(basicFShader, 1, &BasicFS, NULL);
-    glCompileShader(basicFShader);
-
-    GLuint tanVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(tanVShader, 1, &TanVS, NULL);
-    glCompileShader(tanVShader);
-
-    GLuint arcTanVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(arcTanVShader, 1, &ArcTanVS, NULL);
-    glCompileShader(arcTanVShader);
-
-    GLuint arcSinArcCosVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(arcSinArcCosVShader, 1, &ArcSinArcCosVS, NULL);
-    glCompileShader(arcSinArcCosVShader);
-
-    GLuint sinCosRadianVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sinCosRadianVShader, 1, &SinCosRadianVS, NULL);
-    glCompileShader(sinCosRadianVShader);
-
     // Create shader programs
-    basicProgram = glCreateProgram();
-    glAttachShader(basicProgram, basicVShader);
-    glAttachShader(basicProgram, basicFShader);
-    glLinkProgram(basicProgram);
-
-    tanProgram = glCreateProgram();
-    glAttachShader(tanProgram, tanVShader);
-    glAttachShader(tanProgram, basicFShader);
-    glLinkProgram(tanProgram);
-
-    arcTanProgram = glCreateProgram();
-    glAttachShader(arcTanProgram, arcTanVShader);
-    glAttachShader(arcTanProgram, basicFShader);
-    glLinkProgram(arcTanProgram);
-
-    arcSinArcCosProgram = glCreateProgram();
-    glAttachShader(arcSinArcCosProgram, arcSinArcCosVShader);
-    glAttachShader(arcSinArcCosProgram, basicFShader);
-    glLinkProgram(arcSinArcCosProgram);
-
-    sinCosRadianProgram = glCreateProgram();
-    glAttachShader(sinCosRadianProgram, sinCosRadianVShader);
-    glAttachShader(sinCosRadianProgram, basicFShader);
-    glLinkProgram(sinCosRadianProgram);
-
-    glDeleteShader(basicVShader);
-    glDeleteShader(basicFShader);
-    glDeleteShader(tanVShader);
-    glDeleteShader(arcTanVShader);
-    glDeleteShader(arcSinArcCosVShader);
-    glDeleteShader(sinCosRadianVShader);
-
-    float graphLine[] ={
-            -1.0f,0.0f,0.0f,
-            -0.9f,0.0f,0.0f
-    };
+    basicProgram = buildProgram("angle&trigonometry.basic", BasicVS, BasicFS);
+    tanProgram = buildProgram("angle&trigonometry.tan", TanVS, BasicFS);
+    arcTanProgram = buildProgram("angle&trigonometry.arcTan", ArcTanVS, BasicFS);
+    arcSinArcCosProgram = buildProgram("angle&trigonometry.arcSinArcCos", ArcSinArcCosVS, BasicFS);
+    sinCosRadianProgram = buildProgram("angle&trigonometry.sinCosRadian", SinCosRadianVS, BasicFS);
 
     float xAndYAxis[] = {
             -1.0f, 0.0f, 0.0f,  // X-axis start point
@@ -188,54 +136,94 @@ void init() {
             0.0f, 1.0f, 0.0f    // Y-axis end point
     };
 
-    float line[] ={
-            0.0f,0.0f,0.0f,
-            0.5f,0.0f,0.0f
-    };
-
     glGenBuffers(1, &xAndYAxisVBO);
-    glGenBuffers(1, &lineVBO);
-    glGenBuffers(1,&graphLineVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, graphLineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(graphLine), graphLine, GL_STATIC_DRAW);
+    // 0 <= angle < 360, one spoke of length 0.5 per --fan-step degrees
+    createFan(&fan, 0.5f, curveFanStep());
 
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(line), line, GL_STATIC_DRAW);
+    // Each curve is sampled once over the x range it is plotted on; the shaders
+    // evaluate the function per vertex with uPosX left at 0.
+    createPlot(&tanCurve, tanPlot, -0.5f, 0.45f);
+    createPlot(&arcSinCurve, arcSinPlot, -0.95f, 0.95f);
+    createPlot(&arcCosCurve, arcCosPlot, -0.95f, 0.95f);
+    createPlot(&arcTanCurve, arcTanPlot, -1.0f, 1.0f);
 
-    glBindBuffer(GL_ARRAY_BUFFER, xAndYAxisVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, xAndYAxisVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(xAndYAxis), xAndYAxis, GL_STATIC_DRAW);
 
-    decision = glGetUniformLocation(arcSinArcCosProgram, "uDecision");
-    tanPosX = glGetUniformLocation(tanProgram, "uPosX");
-    sinCosRadianAngle = glGetUniformLocation(sinCosRadianProgram, "uAngle");
-    arcPosX = glGetUniformLocation(arcSinArcCosProgram, "uPosX");
-    arcTanPosX = glGetUniformLocation(arcTanProgram, "uPosX");
+    decision = programUniform(arcSinArcCosProgram, "uDecision");
 
+}
+
+// Uniform samples by default, adaptive ones with --plot-error. Each quadrant's
+// clip space spans half the window, so one unit is a quarter of it in pixels.
+static void createPlot(struct Curve *curve, float (*f)(float), float xMin, float xMax) {
+    if (curvePlotError() > 0.0f) {
+        curveCreateAdaptive(curve, f, xMin, xMax, g_width / 4.0f, g_height / 4.0f, curvePlotError());
+    } else {
+        curveCreate(curve, xMin, xMax, curveSamples());
+    }
+}
 
+// Builds a GL_LINES buffer with one spoke per step; each vertex is aPos
+// (distance from the center along x) followed by aAngle in degrees.
+static void createFan(struct Curve *fan, float length, float step) {
+    int spokes = 0;
+    while (spokes * step < 360.0f) spokes++;
+
+    float *vertices = malloc(spokes * 2 * 4 * sizeof(float));
+    for (int i = 0; i < spokes; i++) {
+        float *v = vertices + i * 8;
+        v[0] = 0.0f;   v[1] = 0.0f; v[2] = 0.0f; v[3] = step * i;
+        v[4] = length; v[5] = 0.0f; v[6] = 0.0f; v[7] = step * i;
+    }
+
+    glGenBuffers(1, &fan->vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, fan->vbo);
+    glBufferData(GL_ARRAY_BUFFER, spokes * 2 * 4 * sizeof(float), vertices, GL_STATIC_DRAW);
+    fan->mode = GL_LINES;
+    fan->count = spokes * 2;
+    fan->runs = NULL;
+    fan->runCount = 0;
+
+    free(vertices);
 }
 
-void drawLine(GLuint programID, unsigned int VBO, int size, float color[3]) {
-    glUseProgram(programID);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    GLuint posAttrib = glGetAttribLocation(programID, "aPos");
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(posAttrib);
-    glUniform3fv(glGetUniformLocation(programID, "uColor"), 1, color);
-    glDrawArrays(GL_LINES,0,size);
+static void drawFan(GLuint program, const struct Curve *fan, float color[3]) {
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, fan->vbo);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    GLuint angleAttrib = programAttrib(program, "aAngle");
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    stateVertexAttribPointer(angleAttrib, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(3 * sizeof(float)));
+    stateEnableVertexAttribArray(posAttrib);
+    stateEnableVertexAttribArray(angleAttrib);
+    glUniform3fv(programUniform(program, "uColor"), 1, color);
+    glDrawArrays(GL_LINES, 0, fan->count);
+    stateDisableVertexAttribArray(angleAttrib);
 }
 
-void drawAxis(GLuint program, unsigned int VBO, float color[3]){
-    glUseProgram(program);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    GLuint posAttrib = glGetAttribLocation(program, "aPos");
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(posAttrib);
-    glUniform3fv(glGetUniformLocation(program, "uColor"), 1, color);
+static void drawAxis(GLuint program, unsigned int VBO, float color[3]){
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+    glUniform3fv(programUniform(program, "uColor"), 1, color);
     glDrawArrays(GL_LINES,0,4);
 }
 
-void draw(){
+static void drawCurve(GLuint program, const struct Curve *curve, float color[3]){
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, curve->vbo);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+    glUniform3fv(programUniform(program, "uColor"), 1, color);
+    curveDraw(curve);
+}
+
+static void draw(){
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -243,12 +231,7 @@ void draw(){
 
     drawAxis(basicProgram, xAndYAxisVBO, navy);
 
-    for(int i = 0; i < 360; i+=5) {
-        glUniform1f(sinCosRadianAngle, 1.0f * i);
-        drawLine(sinCosRadianProgram,lineVBO,2, green);
-        //glfwSwapBuffers(window);
-        //glfwPollEvents();
-    }
+    drawFan(sinCosRadianProgram, &fan, green);
 
     //------------------------------------------------------------------------------
 
@@ -257,12 +240,7 @@ void draw(){
     drawAxis(basicProgram, xAndYAxisVBO, yellow);
 
     // -pi/2 <= x <= pi/2
-    for(int i = 10; i < 28; i+=1) {
-        glUniform1f(tanPosX, 0.05f * i);
-        drawLine(tanProgram,graphLineVBO,2, navy);
-        // glfwSwapBuffers(window);
-        // glfwPollEvents();
-    }
+    drawCurve(tanProgram, &tanCurve, navy);
 
     //------------------------------------------------------------------------------
     glViewport(0, 0, g_width/2, g_height/2); // [1,0]
@@ -270,15 +248,11 @@ void draw(){
     drawAxis(basicProgram, xAndYAxisVBO, yellow);
 
     // -1 <= x <= 1
-    for(int i = 1; i < 38; i+=1) {
-        glUniform1f(arcPosX, 0.05f * i);
-        glUniform1i(decision, 1);
-        drawLine(arcSinArcCosProgram, graphLineVBO, 2, navy);
-        glUniform1i(decision, 0);
-        drawLine(arcSinArcCosProgram, graphLineVBO, 2, green);
-        //glfwSwapBuffers(window);
-        //glfwPollEvents();
-    }
+    stateUseProgram(arcSinArcCosProgram);
+    glUniform1i(decision, 1);
+    drawCurve(arcSinArcCosProgram, &arcCosCurve, navy);
+    glUniform1i(decision, 0);
+    drawCurve(arcSinArcCosProgram, &arcSinCurve, green);
 
     //------------------------------------------------------------------------------
 
@@ -287,14 +261,5 @@ void draw(){
     drawAxis(basicProgram, xAndYAxisVBO, green);
 
     // -1 <= x <= 1
-    for(int i = 0; i < 40; i+=1) {
-        glUniform1f(arcTanPosX, 0.05f * i);
-        drawLine(arcTanProgram,graphLineVBO,2, navy);
-
-        //glfwSwapBuffers(window);
-        //glfwPollEvents();
-    }
-
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    drawCurve(arcTanProgram, &arcTanCurve, navy);
 }
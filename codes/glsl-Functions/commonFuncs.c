@@ -1,24 +1,27 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
-#include <GLFW/glfw3.h>
+#include "../common/glState.h"
+#include "../common/glslGen.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
+#include "../common/verdict.h"
 #include <GLES2/gl2.h>
 
 #define WINDOW_WIDTH 1200
 #define WINDOW_HEIGHT 900
-#define TEST_COUNT 12
-#define GRID_COLS 4
-#define GRID_ROWS 3
 
-void init();
-void draw();
-void renderTest(int testIndex);
+static void init();
+static void cleanup();
+static void draw();
+static void renderTest(int testIndex);
+static void renderBatched(int windowWidth, int windowHeight, int cellWidth, int cellHeight, int gap);
 
 // Static global variables
-static GLFWwindow* window;
-static GLuint vbo;
-static int passedTests = 0;
+static GLuint vbo, cellVbo;
+static int g_width = WINDOW_WIDTH, g_height = WINDOW_HEIGHT;
 
 // Quad vertices (position + texture coordinates)
 static const float quadVertices[] = {
@@ -28,242 +31,255 @@ static const float quadVertices[] = {
     1.0f,  1.0f, 1.0f, 1.0f   // top right
 };
 
-// Test program and uniform arrays (replacing the struct)
-static GLuint programs[TEST_COUNT];
+// Where a builtin argument comes from: the cell's x or y coordinate mapped
+// through the case's domain, or a constant.
+enum ArgKind { ARG_X, ARG_Y, ARG_CONST };
 
-int main() {
-    // Initialize GLFW
-    if (!glfwInit()) {
-        printf("Failed to initialize GLFW\n");
-        exit(-1);
-    }
-
-    // Configure GLFW for OpenGL ES 2.0
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_ANY_PROFILE);
+struct Arg {
+    enum ArgKind kind;
+    float value;
+};
 
-    // Create window
-    window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "GLSL Common Functions Grid", NULL, NULL);
+#define X {ARG_X, 0.0f}
+#define Y {ARG_Y, 0.0f}
+#define C(v) {ARG_CONST, v}
+
+// One generated cell: builtin(args) with x = u * domainScale + domainOffset
+// (y likewise from v), wrapped to mod(result, period) when period is non-zero
+// and shown as result * normScale + normOffset. reference() is the CPU version
+// of the builtin and provides the expected value of every pixel.
+struct BuiltinCase {
+    const char *name;
+    const char *builtin;
+    int arity;
+    struct Arg args[3];
+    float (*reference)(float a, float b, float c);
+    float domainScale, domainOffset;
+    float period, normScale, normOffset;
+};
 
-    // Make context current
-    glfwMakeContextCurrent(window);
+static float refAbs(float a, float b, float c) { (void)b; (void)c; return fabsf(a); }
+static float refSign(float a, float b, float c) { (void)b; (void)c; return (float)((a > 0.0f) - (a < 0.0f)); }
+static float refFloor(float a, float b, float c) { (void)b; (void)c; return floorf(a); }
+static float refCeil(float a, float b, float c) { (void)b; (void)c; return ceilf(a); }
+static float refFract(float a, float b, float c) { (void)b; (void)c; return a - floorf(a); }
+static float refMod(float a, float b, float c) { (void)c; return a - b * floorf(a / b); }
+static float refMin(float a, float b, float c) { (void)c; return fminf(a, b); }
+static float refMax(float a, float b, float c) { (void)c; return fmaxf(a, b); }
+static float refClamp(float a, float b, float c) { return fminf(fmaxf(a, b), c); }
+static float refMix(float a, float b, float c) { return a * (1.0f - c) + b * c; }
+static float refStep(float a, float b, float c) { (void)c; return b < a ? 0.0f : 1.0f; }
+static float refSmoothstep(float a, float b, float c) {
+    float t = fminf(fmaxf((c - a) / (b - a), 0.0f), 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
 
-    init();
+// Adding a row adds a cell; the grid grows to fit.
+static const struct BuiltinCase cases[] = {
+    {"abs",        "abs",        1, {X},             refAbs,        5.0f, -2.5f, 0.0f, 0.4f,  0.0f},
+    {"sign",       "sign",       1, {X},             refSign,       5.0f, -2.5f, 0.0f, 0.5f,  0.5f},
+    {"floor",      "floor",      1, {X},             refFloor,      5.0f,  0.0f, 4.0f, 0.25f, 0.0f},
+    {"ceil",       "ceil",       1, {X},             refCeil,       5.0f,  0.0f, 4.0f, 0.25f, 0.0f},
+    {"fract",      "fract",      1, {X},             refFract,      5.0f,  0.0f, 0.0f, 1.0f,  0.0f},
+    {"mod",        "mod",        2, {X, C(2.0f)},    refMod,        5.0f,  0.0f, 0.0f, 0.5f,  0.0f},
+    {"min",        "min",        2, {X, Y},          refMin,        1.0f,  0.0f, 0.0f, 1.0f,  0.0f},
+    {"max",        "max",        2, {X, Y},          refMax,        1.0f,  0.0f, 0.0f, 1.0f,  0.0f},
+    {"clamp",      "clamp",      3, {X, C(0.2f), C(0.8f)}, refClamp, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f},
+    {"mix",        "mix",        3, {X, Y, C(0.5f)}, refMix,        1.0f,  0.0f, 0.0f, 1.0f,  0.0f},
+    {"step",       "step",       2, {C(0.5f), X},    refStep,       1.0f,  0.0f, 0.0f, 1.0f,  0.0f},
+    {"smoothstep", "smoothstep", 3, {C(0.3f), C(0.7f), X}, refSmoothstep, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f},
+};
 
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-    }
+#define TEST_COUNT (int)(sizeof(cases) / sizeof(cases[0]))
 
-    // Cleanup
-    glDeleteBuffers(1, &vbo);
+// Test program array and the generated fragment shaders, which stay alive for
+// the whole run because buildProgram() keeps pointers to them
+static GLuint programs[TEST_COUNT], uberProgram, batchedProgram;
+static char *fragmentShaders[TEST_COUNT], *uberShader, *batchedShader;
+static GLint uberTestLoc;
+static int gridCols, gridRows;
 
-    for (int i = 0; i < TEST_COUNT; i++) {
-        glDeleteProgram(programs[i]);
-    }
+static float caseArg(const struct Arg *arg, float x, float y) {
+    return arg->kind == ARG_X ? x : arg->kind == ARG_Y ? y : arg->value;
+}
 
-    glfwTerminate();
+static float expectCase(const void *data, float u, float v) {
+    const struct BuiltinCase *test = data;
+    float x = u * test->domainScale + test->domainOffset;
+    float y = v * test->domainScale + test->domainOffset;
+    float result = test->reference(caseArg(&test->args[0], x, y), caseArg(&test->args[1], x, y),
+                                   caseArg(&test->args[2], x, y));
 
-    return 0;
+    if (test->period != 0.0f) {
+        result = refMod(result, test->period, 0.0f);
+    }
+    return result * test->normScale + test->normOffset;
 }
 
-void init() {
-
-    // Embedded shader strings
-    const char* vertexShaderSource =
-        "#version 100\n"
-        "attribute vec2 a_position;\n"
-        "attribute vec2 a_texCoord;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
-        "    v_texCoord = a_texCoord;\n"
-        "}\n";
+// The statements computing "normalized" for one case, shared by its own
+// shader and the uber-shader
+static char *caseBody(const struct BuiltinCase *test, const char *indent) {
+    char call[256], scale[32], offset[32], period[32], normScale[32], normOffset[32];
+    char *end = call + sprintf(call, "%s(", test->builtin);
+
+    for (int i = 0; i < test->arity; i++) {
+        const struct Arg *arg = &test->args[i];
+        char value[32];
+        end += sprintf(end, "%s%s", i ? ", " : "",
+                       arg->kind == ARG_X ? "x" : arg->kind == ARG_Y ? "y" : glslFloat(value, arg->value));
+    }
+    strcpy(end, ")");
 
-    const char* absFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = (uv.x - 0.5) * 5.0;\n"
-        "    float result = abs(x);\n"
-        "    float normalized = result / (2.5);\n"
-        "    gl_FragColor = vec4(normalized, normalized, normalized, 1.0);\n"
-        "}\n";
+    char wrapped[64] = "result";
+    if (test->period != 0.0f) {
+        snprintf(wrapped, sizeof(wrapped), "mod(result, %s)", glslFloat(period, test->period));
+    }
 
-    const char* signFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = (uv.x - 0.5) * 5.0;\n"
-        "    float result = sign(x);\n"
-        "    float normalized = (result + 1.0) * 0.5;\n"
-        "    gl_FragColor = vec4(normalized, normalized, normalized, 1.0);\n"
-        "}\n";
+    return formatSource(
+        "%svec2 uv = v_texCoord * %s + %s;\n"
+        "%sfloat x = uv.x;\n"
+        "%sfloat y = uv.y;\n"
+        "%sfloat result = %s;\n"
+        "%snormalized = %s * %s + %s;\n",
+        indent, glslFloat(scale, test->domainScale), glslFloat(offset, test->domainOffset),
+        indent, indent, indent, call,
+        indent, wrapped, glslFloat(normScale, test->normScale), glslFloat(normOffset, test->normOffset));
+}
 
-    const char* floorFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x * 5.0;\n"
-        "    float result = floor(x);\n"
-        "    float normalized = mod(result, 4.0) / 4.0;\n"
-        "    gl_FragColor = vec4(normalized, normalized, normalized, 1.0);\n"
-        "}\n";
+// testIndex < 0 generates the uber-shader, which runs the case selected by
+// the uTest uniform, or by the per-vertex cell index when batched
+static char *generateShader(int testIndex, int batched) {
+    int first = testIndex < 0 ? 0 : testIndex, last = testIndex < 0 ? TEST_COUNT : testIndex + 1;
+    char *bodies[TEST_COUNT];
+    size_t size = 16;
 
-    const char* ceilFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x * 5.0;\n"
-        "    float result = ceil(x);\n"
-        "    float normalized = mod(result, 4.0) / 4.0;\n"
-        "    gl_FragColor = vec4(normalized, normalized, normalized, 1.0);\n"
-        "}\n";
+    for (int i = first; i < last; i++) {
+        bodies[i] = caseBody(&cases[i], testIndex < 0 ? "        " : "    ");
+        size += strlen(bodies[i]) + 32;
+    }
 
-    const char* fractFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x * 5.0;\n"
-        "    float result = fract(x);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
-        "}\n";
+    char *selection = malloc(size);
+    char *end = selection;
+    *end = '\0';
+    for (int i = first; i < last; i++) {
+        if (testIndex < 0) {
+            end += sprintf(end, "    %sif (test == %d) {\n", i ? "} else " : "", i);
+        }
+        end += sprintf(end, "%s", bodies[i]);
+        free(bodies[i]);
+    }
+    if (testIndex < 0) {
+        strcpy(end, "    }\n");
+    }
 
-    const char* modFragmentShader =
+    char *source = formatSource(
         "#version 100\n"
         "precision mediump float;\n"
+        "%s"
         "varying vec2 v_texCoord;\n"
         "\n"
         "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x * 5.0;\n"
-        "    float y = 2.0;\n"
-        "    float result = mod(x, y);\n"
-        "    float normalized = result / y;\n"
+        "%s"
+        "    float normalized = 0.0;\n"
+        "%s"
         "    gl_FragColor = vec4(normalized, normalized, normalized, 1.0);\n"
-        "}\n";
+        "}\n",
+        testIndex >= 0 ? "" : batched ? "varying float v_cell;\n" : "uniform int uTest;\n",
+        testIndex >= 0 ? "" : batched ? "    int test = int(v_cell + 0.5);\n" : "    int test = uTest;\n",
+        selection);
+    free(selection);
+    return source;
+}
 
-    const char* minFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float result = min(uv.x, uv.y);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
-        "}\n";
+static void cleanup() {
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &cellVbo);
+    cellVbo = 0;
 
-    const char* maxFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float result = max(uv.x, uv.y);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
-        "}\n";
+    for (int i = 0; i < TEST_COUNT; i++) {
+        glDeleteProgram(programs[i]);
+        programs[i] = 0;
+    }
+    glDeleteProgram(uberProgram);
+    glDeleteProgram(batchedProgram);
+    uberProgram = batchedProgram = 0;
+}
 
-    const char* clampFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float result = clamp(uv.x, 0.2, 0.8);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
-        "}\n";
+const struct Suite commonFuncsSuite = {
+    "commonFuncs", "GLSL Common Functions Grid", "glsl-Functions/CommonFunctions.png", &g_width, &g_height, 0, init, draw, cleanup
+};
 
-    const char* mixFragmentShader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec2 v_texCoord;\n"
-        "\n"
-        "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float result = mix(uv.x, uv.y, 0.5);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
-        "}\n";
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&commonFuncsSuite, argc, argv);
+}
+#endif
 
-    const char* stepFragmentShader =
+static void init() {
+
+    // Embedded shader strings
+    const char* vertexShaderSource =
         "#version 100\n"
-        "precision mediump float;\n"
+        "attribute vec2 a_position;\n"
+        "attribute vec2 a_texCoord;\n"
         "varying vec2 v_texCoord;\n"
         "\n"
         "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x;\n"
-        "    float edge = 0.5;\n"
-        "    float result = step(edge, x);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
+        "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
+        "    v_texCoord = a_texCoord;\n"
         "}\n";
 
-    const char* smoothstepFragmentShader =
+    // With --batched-cells every cell quad is baked into one VBO with its cell
+    // index, and the vertex shader places it in the grid
+    const char* batchedVertexSource =
         "#version 100\n"
-        "precision mediump float;\n"
+        "attribute vec3 a_corner;  // quad corner in [0, 1], cell index\n"
+        "uniform vec2 uGrid;       // columns, rows\n"
+        "uniform vec2 uCellSize;   // pixels\n"
+        "uniform vec2 uFramebuffer;\n"
+        "uniform float uGap;\n"
         "varying vec2 v_texCoord;\n"
+        "varying float v_cell;\n"
         "\n"
         "void main() {\n"
-        "    vec2 uv = v_texCoord;\n"
-        "    float x = uv.x;\n"
-        "    float edge0 = 0.3;\n"
-        "    float edge1 = 0.7;\n"
-        "    float result = smoothstep(edge0, edge1, x);\n"
-        "    gl_FragColor = vec4(result, result, result, 1.0);\n"
+        "    float row = floor((a_corner.z + 0.5) / uGrid.x);\n"
+        "    float col = a_corner.z - row * uGrid.x;\n"
+        "    vec2 origin = vec2(col, uGrid.y - 1.0 - row) * uCellSize + uGap;\n"
+        "    vec2 pixel = origin + a_corner.xy * (uCellSize - 2.0 * uGap);\n"
+        "    gl_Position = vec4(pixel / uFramebuffer * 2.0 - 1.0, 0.0, 1.0);\n"
+        "    v_texCoord = a_corner.xy;\n"
+        "    v_cell = a_corner.z;\n"
         "}\n";
 
-    // Fragment shader array for easy access
-    const char* fragmentShaders[TEST_COUNT] = {
-        absFragmentShader, signFragmentShader, floorFragmentShader, ceilFragmentShader,
-        fractFragmentShader, modFragmentShader, minFragmentShader, maxFragmentShader,
-        clampFragmentShader, mixFragmentShader, stepFragmentShader, smoothstepFragmentShader
-    };
-
-    // Create vertex shader (shared by all programs)
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    // Create programs for each test
-    passedTests = 0;
-    for (int i = 0; i < TEST_COUNT; i++) {
-        GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragmentShader, 1, &fragmentShaders[i], NULL);
-        glCompileShader(fragmentShader);
-
-        GLuint program = glCreateProgram();
-        glAttachShader(program, vertexShader);
-        glAttachShader(program, fragmentShader);
-        glLinkProgram(program);
-
-        programs[i] = program;
-
-        passedTests++;
-
-        glDeleteShader(fragmentShader);
+    // Create programs for each test, or one uber-shader for all of them with
+    // --uber or --batched-cells; the vertex shader is compiled once and shared
+    if (suiteBatchedCells()) {
+        if (!batchedShader) {
+            batchedShader = generateShader(-1, 1);
+        }
+        batchedProgram = buildProgram("commonFuncs.batched", batchedVertexSource, batchedShader);
+    } else if (suiteUberShader()) {
+        if (!uberShader) {
+            uberShader = generateShader(-1, 0);
+        }
+        uberProgram = buildProgram("commonFuncs.uber", vertexShaderSource, uberShader);
+        uberTestLoc = programUniform(uberProgram, "uTest");
+    } else {
+        for (int i = 0; i < TEST_COUNT; i++) {
+            if (!fragmentShaders[i]) {
+                fragmentShaders[i] = generateShader(i, 0);
+            }
+
+            char name[64];
+            snprintf(name, sizeof(name), "commonFuncs.%s", cases[i].name);
+            programs[i] = buildProgram(name, vertexShaderSource, fragmentShaders[i]);
+        }
     }
 
-    glDeleteShader(vertexShader);
-
+    // Roughly square cells: as many columns as the window's aspect ratio allows
+    gridCols = (int)ceilf(sqrtf(TEST_COUNT * (float)g_width / g_height));
+    if (gridCols > TEST_COUNT) gridCols = TEST_COUNT;
+    gridRows = (TEST_COUNT + gridCols - 1) / gridCols;
 
     // Initialize OpenGL state
     glEnable(GL_BLEND);
@@ -271,71 +287,119 @@ void init() {
 
     // Create VBO
     glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+    if (batchedProgram) {
+        static const float corners[6][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 0}, {1, 1}, {0, 1}};
+        float cellVertices[TEST_COUNT * 6 * 3];
+
+        for (int i = 0; i < TEST_COUNT; i++) {
+            for (int v = 0; v < 6; v++) {
+                float *vertex = cellVertices + (i * 6 + v) * 3;
+                vertex[0] = corners[v][0];
+                vertex[1] = corners[v][1];
+                vertex[2] = (float)i;
+            }
+        }
+
+        glGenBuffers(1, &cellVbo);
+        stateBindBuffer(GL_ARRAY_BUFFER, cellVbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(cellVertices), cellVertices, GL_STATIC_DRAW);
+    }
 }
 
-void draw() {
+static void draw() {
     // Clear screen
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
     // Render all tests in grid layout
     int windowWidth, windowHeight;
-    glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
+    platformGetFramebufferSize(&windowWidth, &windowHeight);
 
     // Calculate cell dimensions with small gaps
-    int cellWidth = windowWidth / GRID_COLS;
-    int cellHeight = windowHeight / GRID_ROWS;
+    int cellWidth = windowWidth / gridCols;
+    int cellHeight = windowHeight / gridRows;
     int gap = 2; // Small gap between cells
 
     // Render each test in its grid position
     for (int i = 0; i < TEST_COUNT; i++) {
 
         // Calculate grid position
-        int col = i % GRID_COLS;
-        int row = i / GRID_COLS;
+        int col = i % gridCols;
+        int row = i / gridCols;
 
         // Calculate viewport position (OpenGL uses bottom-left origin)
         int x = col * cellWidth + gap;
-        int y = (GRID_ROWS - 1 - row) * cellHeight + gap;
+        int y = (gridRows - 1 - row) * cellHeight + gap;
         int w = cellWidth - 2 * gap;
         int h = cellHeight - 2 * gap;
 
+        // Batched cells are placed by the vertex shader and drawn together below
+        if (batchedProgram) {
+            cellRegionExpectData(cases[i].name, x, y, w, h, expectCase, &cases[i]);
+            continue;
+        }
+
         // Set viewport for this cell
-        glViewport(x, y, w, h);
+        cellViewportExpectData(cases[i].name, x, y, w, h, expectCase, &cases[i]);
 
         // Render the test
         renderTest(i);
     }
 
-    // Swap buffers and poll events
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    if (batchedProgram) {
+        glViewport(0, 0, windowWidth, windowHeight);
+        renderBatched(windowWidth, windowHeight, cellWidth, cellHeight, gap);
+    }
 }
 
-void renderTest(int testIndex) {
+// The whole grid in one draw call: same cells as renderTest(), no viewport changes
+static void renderBatched(int windowWidth, int windowHeight, int cellWidth, int cellHeight, int gap) {
+    stateUseProgram(batchedProgram);
+    glUniform2f(programUniform(batchedProgram, "uGrid"), (float)gridCols, (float)gridRows);
+    glUniform2f(programUniform(batchedProgram, "uCellSize"), (float)cellWidth, (float)cellHeight);
+    glUniform2f(programUniform(batchedProgram, "uFramebuffer"), (float)windowWidth, (float)windowHeight);
+    glUniform1f(programUniform(batchedProgram, "uGap"), (float)gap);
+
+    GLint cornerLoc = programAttrib(batchedProgram, "a_corner");
+    stateBindBuffer(GL_ARRAY_BUFFER, cellVbo);
+    stateVertexAttribPointer(cornerLoc, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(cornerLoc);
 
-    glUseProgram(programs[testIndex]);
+    glDrawArrays(GL_TRIANGLES, 0, TEST_COUNT * 6);
+
+    stateDisableVertexAttribArray(cornerLoc);
+}
+
+static void renderTest(int testIndex) {
+
+    // The uber-shader stays bound and only its test selector changes
+    GLuint program = uberProgram ? uberProgram : programs[testIndex];
+    stateUseProgram(program);
+    if (uberProgram) {
+        glUniform1i(uberTestLoc, testIndex);
+    }
 
     // Set up vertex attributes
-    GLint positionLoc = glGetAttribLocation(programs[testIndex], "a_position");
-    GLint texCoordLoc = glGetAttribLocation(programs[testIndex], "a_texCoord");
+    GLint positionLoc = programAttrib(program, "a_position");
+    GLint texCoordLoc = programAttrib(program, "a_texCoord");
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, vbo);
 
     if (positionLoc >= 0) {
-        glVertexAttribPointer(positionLoc, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(positionLoc);
+        stateVertexAttribPointer(positionLoc, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        stateEnableVertexAttribArray(positionLoc);
     }
 
     if (texCoordLoc >= 0) {
-        glVertexAttribPointer(texCoordLoc, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-        glEnableVertexAttribArray(texCoordLoc);
+        stateVertexAttribPointer(texCoordLoc, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        stateEnableVertexAttribArray(texCoordLoc);
     }
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-    if (positionLoc >= 0) glDisableVertexAttribArray(positionLoc);
-    if (texCoordLoc >= 0) glDisableVertexAttribArray(texCoordLoc);
+    if (positionLoc >= 0) stateDisableVertexAttribArray(positionLoc);
+    if (texCoordLoc >= 0) stateDisableVertexAttribArray(texCoordLoc);
 }
@@ -1,66 +1,74 @@
-#include <GLFW/glfw3.h>
+#include "../common/curve.h"
+#include "../common/glState.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
 #include <GLES2/gl2.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-void init();
-void drawLine(GLuint programID, unsigned int VBO, int size, float color[3]);
-void drawAxis(GLuint program, unsigned int VBO, float color[3]);
-void draw();
+static void init();
+static void cleanup();
+static void drawAxis(GLuint program, unsigned int VBO, float color[3]);
+static void createSampleCurve(struct Curve *curve, int first, int last, int variants);
+static void createPlot(struct Curve *curve, int first, int last, float (*variants[])(float), int variantCount, float xScale);
+static void drawSamples(GLuint program, const struct Curve *curve, float color[3], float altColor[3]);
+static void draw();
 
-static float navy[3] = {0.0f, 0.125f, 0.376f};
 static float yellow[3] = {1.0f, 0.835f, 0.0f};
 static float green[3] = {0.0f, 0.65f, 0.2f};
 static float black[3] = {0.0f, 0.0f, 0.0f};
 static float red[3] = {1.0f, 0.0f, 0.0f};
 
-static GLFWwindow *window;
 static GLuint basicProgram, powProgram, expProgram, logProgram, sqrtProgram;
-static unsigned int triangleVBO, rectangleVBO, littleTriangleVBO, xAndYAxisVBO, lineVBO, graphLineVBO;
-
-static GLint powX, expX, expType, logType, logX, sqrtX, sqrtType;
+static unsigned int triangleVBO, rectangleVBO, littleTriangleVBO, xAndYAxisVBO, lineVBO;
+static struct Curve powCurve, expCurve, logCurve, sqrtCurve;
 
 static int g_width = 1400, g_height = 700;
 
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "GLSL Exponential Functions", NULL, NULL);
-    if (window == NULL) {
-        printf("Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(-1);
-    }
-    glfwMakeContextCurrent(window);
-
-    init();
-
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-    }
-
+// CPU versions of what the plot shaders compute, used to place adaptive samples
+static float powPlot(float x) { return powf(x, 3.0f); }
+static float expPlot(float x) { return expf(x) / 2.0f; }
+static float exp2Plot(float x) { return exp2f(x) / 2.0f; }
+static float logPlot(float x) { return logf(x); }
+static float log2Plot(float x) { return log2f(x); }
+static float sqrtPlot(float x) { return x < 0.0f ? 0.0f : sqrtf(x) / 2.0f; }
+static float inverseSqrtPlot(float x) { return x < 0.0f ? 0.0f : 1.0f / sqrtf(x) / 2.0f; }
+
+static float (*powVariants[])(float) = {powPlot};
+static float (*expVariants[])(float) = {expPlot, exp2Plot};
+static float (*logVariants[])(float) = {logPlot, log2Plot};
+static float (*sqrtVariants[])(float) = {sqrtPlot, inverseSqrtPlot};
+
+static void cleanup() {
     glDeleteBuffers(1, &triangleVBO);
     glDeleteBuffers(1, &rectangleVBO);
     glDeleteBuffers(1, &littleTriangleVBO);
     glDeleteBuffers(1, &xAndYAxisVBO);
     glDeleteBuffers(1, &lineVBO);
-    glDeleteBuffers(1, &graphLineVBO);
+    curveDestroy(&powCurve);
+    curveDestroy(&expCurve);
+    curveDestroy(&logCurve);
+    curveDestroy(&sqrtCurve);
     glDeleteProgram(basicProgram);
     glDeleteProgram(powProgram);
     glDeleteProgram(expProgram);
     glDeleteProgram(logProgram);
     glDeleteProgram(sqrtProgram);
+}
+
+const struct Suite exponentialSuite = {
+    "exponential", "GLSL Exponential Functions", "glsl-Functions/Exponential.png", &g_width, &g_height, 4, init, draw, cleanup
+};
 
-    glfwTerminate();
-    printf("Program terminated.\n");
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&exponentialSuite, argc, argv);
 }
+#endif
 
-void init() {
+static void init() {
     const char *BasicVS = "#version 100\n"
                           "attribute vec3 aPos;\n"
                           "void main() {\n"
@@ -74,23 +82,37 @@ void init() {
                           "    gl_FragColor = vec4(uColor, 1.0);\n"
                           "}";
 
+    // aSample.x moves the segment along x, aSample.y picks the function and the
+    // color (0.0: uColor, 1.0: uAltColor).
+    const char *CurveFS = "#version 100\n"
+                          "precision mediump float;\n"
+                          "uniform vec3 uColor;\n"
+                          "uniform vec3 uAltColor;\n"
+                          "varying float vVariant;\n"
+                          "void main() {\n"
+                          "    gl_FragColor = vec4(mix(uColor, uAltColor, vVariant), 1.0);\n"
+                          "}";
+
     const char *PowerVS = "#version 100\n"
                           "attribute vec3 aPos;\n"
-                          "uniform float uPosX;\n"
+                          "attribute vec2 aSample;\n"
+                          "varying float vVariant;\n"
                           "void main() {\n"
-                          "    float newX = aPos.x + uPosX;\n"
+                          "    vVariant = aSample.y;\n"
+                          "    float newX = aPos.x + aSample.x;\n"
                           "    float powY = pow(newX, 3.0);\n"
                           "    gl_Position = vec4(newX, powY, aPos.z, 1.0);\n"
                           "}";
 
     const char *ExpEuVS = "#version 100\n"
                           "attribute vec3 aPos;\n"
-                          "uniform float uPosX;\n"
-                          "uniform int uExpType;\n"
+                          "attribute vec2 aSample;\n"
+                          "varying float vVariant;\n"
                           "void main() {\n"
                           "    float expY = 0.0;\n"
-                          "    float newX = aPos.x + uPosX;\n"
-                          "    if(uExpType == 2) {\n"
+                          "    float newX = aPos.x + aSample.x;\n"
+                          "    vVariant = aSample.y;\n"
+                          "    if(aSample.y > 0.5) {\n"
                           "        expY = exp2(newX)/2.0;\n"
                           "    } else {\n"
                           "        expY = exp(newX)/2.0;\n"
@@ -100,12 +122,13 @@ void init() {
 
     const char *LogVS = "#version 100\n"
                         "attribute vec3 aPos;\n"
-                        "uniform float uPosX;\n"
-                        "uniform int uLogType;\n"
+                        "attribute vec2 aSample;\n"
+                        "varying float vVariant;\n"
                         "void main() {\n"
                         "    float logY = 0.0;\n"
-                        "    float newX = aPos.x + uPosX;\n"
-                        "    if(uLogType == 2) {\n"
+                        "    float newX = aPos.x + aSample.x;\n"
+                        "    vVariant = aSample.y;\n"
+                        "    if(aSample.y > 0.5) {\n"
                         "        logY = log2(newX);\n"
                         "    } else {\n"
                         "        logY = log(newX);\n"
@@ -116,15 +139,16 @@ void init() {
 
     const char *SqrtVS = "#version 100\n"
                          "attribute vec3 aPos;\n"
-                         "uniform float uPosX;\n"
-                         "uniform int uSqrtType;\n"
+                         "attribute vec2 aSample;\n"
+                         "varying float vVariant;\n"
                          "void main() {\n"
                          "    float sqrtY = 0.0;\n"
-                         "    float newX = aPos.x + uPosX;\n"
+                         "    float newX = aPos.x + aSample.x;\n"
+                         "    vVariant = aSample.y;\n"
                          "    if (newX < 0.0) {\n"
                          "        sqrtY = 0.0;\n"
                          "    } else {\n"
-                         "        if (uSqrtType == 1) {\n"
+                         "        if (aSample.y < 0.5) {\n"
                          "            sqrtY = sqrt(newX)/2.0;\n"
                          "        } else {\n"
                          "            sqrtY = inversesqrt(newX)/2.0;\n"
@@ -134,67 +158,12 @@ void init() {
                          "    gl_Position = vec4(newX, sqrtY, aPos.z, 1.0);\n"
                          "}";
 
-    GLuint basicVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(basicVShader, 1, &BasicVS, NULL);
-    glCompileShader(basicVShader);
-
-    GLuint basicFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(basicFShader, 1, &BasicFS, NULL);
-    glCompileShader(basicFShader);
-
-    GLuint powerVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(powerVShader, 1, &PowerVS, NULL);
-    glCompileShader(powerVShader);
-
-    GLuint expEuVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(expEuVShader, 1, &ExpEuVS, NULL);
-    glCompileShader(expEuVShader);
-
-    GLuint logVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(logVShader, 1, &LogVS, NULL);
-    glCompileShader(logVShader);
-
-    GLuint sqrtVShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sqrtVShader, 1, &SqrtVS, NULL);
-    glCompileShader(sqrtVShader);
-
     // Create shader programs
-    basicProgram = glCreateProgram();
-    glAttachShader(basicProgram, basicVShader);
-    glAttachShader(basicProgram, basicFShader);
-    glLinkProgram(basicProgram);
-
-    powProgram = glCreateProgram();
-    glAttachShader(powProgram, powerVShader);
-    glAttachShader(powProgram, basicFShader);
-    glLinkProgram(powProgram);
-
-    expProgram = glCreateProgram();
-    glAttachShader(expProgram, expEuVShader);
-    glAttachShader(expProgram, basicFShader);
-    glLinkProgram(expProgram);
-
-    logProgram = glCreateProgram();
-    glAttachShader(logProgram, logVShader);
-    glAttachShader(logProgram, basicFShader);
-    glLinkProgram(logProgram);
-
-    sqrtProgram = glCreateProgram();
-    glAttachShader(sqrtProgram, sqrtVShader);
-    glAttachShader(sqrtProgram, basicFShader);
-    glLinkProgram(sqrtProgram);
-
-    glDeleteShader(basicVShader);
-    glDeleteShader(basicFShader);
-    glDeleteShader(powerVShader);
-    glDeleteShader(expEuVShader);
-    glDeleteShader(logVShader);
-    glDeleteShader(sqrtVShader);
-
-    float graphLine[] = {
-        -1.0f, 0.0f, 0.0f,
-        -0.95f, 0.0f, 0.0f
-    };
+    basicProgram = buildProgram("exponential.basic", BasicVS, BasicFS);
+    powProgram = buildProgram("exponential.pow", PowerVS, CurveFS);
+    expProgram = buildProgram("exponential.exp", ExpEuVS, CurveFS);
+    logProgram = buildProgram("exponential.log", LogVS, CurveFS);
+    sqrtProgram = buildProgram("exponential.sqrt", SqrtVS, CurveFS);
 
     // Triangle vertices
     float triangleVertices[] = {
@@ -237,56 +206,142 @@ void init() {
     glGenBuffers(1, &littleTriangleVBO);
     glGenBuffers(1, &xAndYAxisVBO);
     glGenBuffers(1, &lineVBO);
-    glGenBuffers(1, &graphLineVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, graphLineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(graphLine), graphLine, GL_STATIC_DRAW);
+    // -1 <= x <= 1; log and sqrt halve x in the shader, hence their longer ranges
+    createPlot(&powCurve, 0, 40, powVariants, 1, 1.0f);
+    createPlot(&expCurve, 0, 40, expVariants, 2, 1.0f);
+    createPlot(&logCurve, 0, 81, logVariants, 2, 0.5f);
+    createPlot(&sqrtCurve, 19, 80, sqrtVariants, 2, 0.5f);
 
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, lineVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(line), line, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, littleTriangleVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, littleTriangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(littleTriangleVertices), littleTriangleVertices, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ARRAY_BUFFER, xAndYAxisVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, xAndYAxisVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(xAndYAxis), xAndYAxis, GL_STATIC_DRAW);
+}
+
+// Builds one GL_LINES buffer holding a 0.05-wide segment for every step in
+// [first, last) and every variant, in the order they are drawn. Each vertex is
+// aPos (xyz) followed by aSample (x offset, variant).
+static void createSampleCurve(struct Curve *curve, int first, int last, int variants) {
+    int count = (last - first) * variants * 2;
+    float *vertices = malloc(count * 5 * sizeof(float));
+    float *v = vertices;
+
+    for (int i = first; i < last; i++) {
+        for (int variant = 0; variant < variants; variant++) {
+            for (int end = 0; end < 2; end++) {
+                *v++ = end ? -0.95f : -1.0f;
+                *v++ = 0.0f;
+                *v++ = 0.0f;
+                *v++ = 0.05f * i;
+                *v++ = (float)variant;
+            }
+        }
+    }
+
+    glGenBuffers(1, &curve->vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, curve->vbo);
+    glBufferData(GL_ARRAY_BUFFER, count * 5 * sizeof(float), vertices, GL_STATIC_DRAW);
+    curve->mode = GL_LINES;
+    curve->count = count;
+    curve->runs = NULL;
+    curve->runCount = 0;
 
-    powX = glGetUniformLocation(powProgram, "uPosX");
-    expX = glGetUniformLocation(expProgram, "uPosX");
-    expType = glGetUniformLocation(expProgram, "uExpType");
-    logType = glGetUniformLocation(logProgram, "uLogType");
-    logX = glGetUniformLocation(logProgram, "uPosX");
-    sqrtX = glGetUniformLocation(sqrtProgram, "uPosX");
-    sqrtType = glGetUniformLocation(sqrtProgram, "uSqrtType");
+    free(vertices);
 }
 
-void drawLine(GLuint programID, unsigned int VBO, int size, float color[3]) {
-    glUseProgram(programID);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    GLuint posAttrib = glGetAttribLocation(programID, "aPos");
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(posAttrib);
-    glUniform3fv(glGetUniformLocation(programID, "uColor"), 1, color);
-    glDrawArrays(GL_LINES, 0, size);
+// With --plot-error the same x range is covered by adaptive line strips
+// instead, the runs of each variant in turn with a zero x offset. xScale is
+// what the shader multiplies x by before output.
+static void createPlot(struct Curve *curve, int first, int last, float (*variants[])(float), int variantCount, float xScale) {
+    if (curvePlotError() <= 0.0f) {
+        createSampleCurve(curve, first, last, variantCount);
+        return;
+    }
+
+    float xMin = -1.0f + 0.05f * first;
+    float xMax = -0.95f + 0.05f * (last - 1);
+    float *vertices = NULL;
+    int *runs = NULL;
+    int count = 0, runCount = 0;
+
+    for (int variant = 0; variant < variantCount; variant++) {
+        float *points;
+        int *variantRuns, variantRunCount;
+        int pointCount = curveSampleAdaptive(variants[variant], xMin, xMax, g_width / 4.0f * xScale, g_height / 4.0f,
+                                             curvePlotError(), &points, &variantRuns, &variantRunCount);
+
+        // Nothing of this variant is in view
+        if (pointCount == 0) {
+            continue;
+        }
+
+        vertices = realloc(vertices, (count + pointCount) * 5 * sizeof(float));
+        for (int i = 0; i < pointCount; i++) {
+            float *v = vertices + (count + i) * 5;
+            v[0] = points[i];
+            v[1] = 0.0f;
+            v[2] = 0.0f;
+            v[3] = 0.0f;
+            v[4] = (float)variant;
+        }
+
+        runs = realloc(runs, (runCount + variantRunCount) * sizeof(int));
+        memcpy(runs + runCount, variantRuns, variantRunCount * sizeof(int));
+
+        count += pointCount;
+        runCount += variantRunCount;
+        free(points);
+        free(variantRuns);
+    }
+
+    glGenBuffers(1, &curve->vbo);
+    stateBindBuffer(GL_ARRAY_BUFFER, curve->vbo);
+    glBufferData(GL_ARRAY_BUFFER, count * 5 * sizeof(float), vertices, GL_STATIC_DRAW);
+    curve->mode = GL_LINE_STRIP;
+    curve->count = count;
+    curve->runs = runs;
+    curve->runCount = runCount;
+
+    free(vertices);
 }
 
-void drawAxis(GLuint program, unsigned int VBO, float color[3]) {
-    glUseProgram(program);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    GLuint posAttrib = glGetAttribLocation(program, "aPos");
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(posAttrib);
-    glUniform3fv(glGetUniformLocation(program, "uColor"), 1, color);
+static void drawAxis(GLuint program, unsigned int VBO, float color[3]) {
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(posAttrib);
+    glUniform3fv(programUniform(program, "uColor"), 1, color);
     glDrawArrays(GL_LINES, 0, 4);
 }
 
-void draw() {
+static void drawSamples(GLuint program, const struct Curve *curve, float color[3], float altColor[3]) {
+    stateUseProgram(program);
+    stateBindBuffer(GL_ARRAY_BUFFER, curve->vbo);
+    GLuint posAttrib = programAttrib(program, "aPos");
+    GLuint sampleAttrib = programAttrib(program, "aSample");
+    stateVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    stateVertexAttribPointer(sampleAttrib, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    stateEnableVertexAttribArray(posAttrib);
+    stateEnableVertexAttribArray(sampleAttrib);
+    glUniform3fv(programUniform(program, "uColor"), 1, color);
+    glUniform3fv(programUniform(program, "uAltColor"), 1, altColor);
+    curveDraw(curve);
+    stateDisableVertexAttribArray(sampleAttrib);
+}
+
+static void draw() {
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -294,61 +349,26 @@ void draw() {
 
     drawAxis(basicProgram, xAndYAxisVBO, black);
 
-    // -1 <= x <= 1
-    for(int i = 0; i < 40; i+=1) {
-        glUniform1f(powX, 0.05f * i);
-        drawLine(powProgram, graphLineVBO, 2, yellow);
-    }
+    drawSamples(powProgram, &powCurve, yellow, yellow);
 
     glViewport(g_width/2, g_height/2, g_width/2, g_height/2); // [0,1]
 
     drawAxis(basicProgram, xAndYAxisVBO, red);
 
-    // -1 <= x <= 1
-    for(int i = 0; i < 40; i+=1) {
-        glUniform1f(expX, 0.05f * i);
-        // e^x function
-        glUniform1i(expType, 0);
-        drawLine(expProgram, graphLineVBO, 2, green);
-
-        // 2^x function
-        glUniform1i(expType, 2);
-        drawLine(expProgram, graphLineVBO, 2, yellow);
-    }
+    // e^x in green, 2^x in yellow
+    drawSamples(expProgram, &expCurve, green, yellow);
 
     glViewport(0, 0, g_width/2, g_height/2); // [1,0]
 
     drawAxis(basicProgram, xAndYAxisVBO, red);
 
-    // -1 <= x <= 1
-    // x values are divided into 2 in the shader so loop is 81
-    for(int i = 0; i < 81; i+=1) {
-        glUniform1f(logX, 0.05f * i);
-        // Ln function
-        glUniform1i(logType, 0);
-        drawLine(logProgram, graphLineVBO, 2, green);
-
-        // Log2 function
-        glUniform1i(logType, 2);
-        drawLine(logProgram, graphLineVBO, 2, yellow);
-    }
+    // Ln in green, log2 in yellow
+    drawSamples(logProgram, &logCurve, green, yellow);
 
     glViewport(g_width/2, 0, g_width/2, g_height/2); // [1,1]
 
     drawAxis(basicProgram, xAndYAxisVBO, black);
 
-    // -1 <= x <= 1
-    for(int i = 19; i < 80; i+=1) {
-        glUniform1f(sqrtX, 0.05f * i);
-        // Sqrt function
-        glUniform1i(sqrtType, 1);
-        drawLine(sqrtProgram, graphLineVBO, 2, yellow);
-
-        // Inverse Sqrt function
-        glUniform1i(sqrtType, 0);
-        drawLine(sqrtProgram, graphLineVBO, 2, green);
-    }
-
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    // Sqrt in yellow, inverse sqrt in green
+    drawSamples(sqrtProgram, &sqrtCurve, yellow, green);
 }
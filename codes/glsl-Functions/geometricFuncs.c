@@ -1,13 +1,16 @@
-#include <GLFW/glfw3.h>
+#include "../common/glState.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
+#include "../common/verdict.h"
 #include <GLES2/gl2.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-void init();
-void draw();
+static void init();
+static void cleanup();
+static void draw();
 
 // Static global variables
-static GLFWwindow *window;
 static GLuint basicProgram, lengthProgram, distanceProgram, normalizeProgram;
 static GLuint faceforwardProgram, reflectProgram, refractProgram;
 static unsigned int rectangleVBO;
@@ -40,27 +43,7 @@ static float refract_eta = 0.75f;                     // refraction index ratio
 
 static int g_width = 1280, g_height = 720;
 
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "GLSL Geometric Functions", NULL, NULL);
-    if (window == NULL) {
-        printf("Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(-1);
-    }
-    glfwMakeContextCurrent(window);
-
-    init();
-
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-    }
-
+static void cleanup() {
     glDeleteBuffers(1, &rectangleVBO);
     glDeleteProgram(basicProgram);
     glDeleteProgram(lengthProgram);
@@ -69,13 +52,19 @@ int main() {
     glDeleteProgram(faceforwardProgram);
     glDeleteProgram(reflectProgram);
     glDeleteProgram(refractProgram);
+}
+
+const struct Suite geometricFuncsSuite = {
+    "geometricFuncs", "GLSL Geometric Functions", "glsl-Functions/geometricFuncs.png", &g_width, &g_height, 4, init, draw, cleanup
+};
 
-    glfwTerminate();
-    printf("Program terminated.\n");
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&geometricFuncsSuite, argc, argv);
 }
+#endif
 
-void init() {
+static void init() {
 
     // Embedded shader strings
     const char *BasicVS = "#version 100\n"
@@ -204,85 +193,14 @@ void init() {
                             "    gl_FragColor = color;\n"
                             "}";
 
-    // Create vertex shader (shared by all programs)
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &BasicVS, NULL);
-    glCompileShader(vertexShader);
-
-    // Create fragment shaders
-    GLuint basicFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(basicFShader, 1, &BasicFS, NULL);
-    glCompileShader(basicFShader);
-
-    GLuint lengthFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(lengthFShader, 1, &LengthFS, NULL);
-    glCompileShader(lengthFShader);
-
-    GLuint distanceFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(distanceFShader, 1, &DistanceFS, NULL);
-    glCompileShader(distanceFShader);
-
-    GLuint normalizeFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(normalizeFShader, 1, &NormalizeFS, NULL);
-    glCompileShader(normalizeFShader);
-
-    GLuint faceforwardFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(faceforwardFShader, 1, &FaceforwardFS, NULL);
-    glCompileShader(faceforwardFShader);
-
-    GLuint reflectFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(reflectFShader, 1, &ReflectFS, NULL);
-    glCompileShader(reflectFShader);
-
-    GLuint refractFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(refractFShader, 1, &RefractFS, NULL);
-    glCompileShader(refractFShader);
-
     // Create shader programs
-    basicProgram = glCreateProgram();
-    glAttachShader(basicProgram, vertexShader);
-    glAttachShader(basicProgram, basicFShader);
-    glLinkProgram(basicProgram);
-
-    lengthProgram = glCreateProgram();
-    glAttachShader(lengthProgram, vertexShader);
-    glAttachShader(lengthProgram, lengthFShader);
-    glLinkProgram(lengthProgram);
-
-    distanceProgram = glCreateProgram();
-    glAttachShader(distanceProgram, vertexShader);
-    glAttachShader(distanceProgram, distanceFShader);
-    glLinkProgram(distanceProgram);
-
-    normalizeProgram = glCreateProgram();
-    glAttachShader(normalizeProgram, vertexShader);
-    glAttachShader(normalizeProgram, normalizeFShader);
-    glLinkProgram(normalizeProgram);
-
-    faceforwardProgram = glCreateProgram();
-    glAttachShader(faceforwardProgram, vertexShader);
-    glAttachShader(faceforwardProgram, faceforwardFShader);
-    glLinkProgram(faceforwardProgram);
-
-    reflectProgram = glCreateProgram();
-    glAttachShader(reflectProgram, vertexShader);
-    glAttachShader(reflectProgram, reflectFShader);
-    glLinkProgram(reflectProgram);
-
-    refractProgram = glCreateProgram();
-    glAttachShader(refractProgram, vertexShader);
-    glAttachShader(refractProgram, refractFShader);
-    glLinkProgram(refractProgram);
-
-    // Clean up shaders
-    glDeleteShader(vertexShader);
-    glDeleteShader(basicFShader);
-    glDeleteShader(lengthFShader);
-    glDeleteShader(distanceFShader);
-    glDeleteShader(normalizeFShader);
-    glDeleteShader(faceforwardFShader);
-    glDeleteShader(reflectFShader);
-    glDeleteShader(refractFShader);
+    basicProgram = buildProgram("geometricFuncs.basic", BasicVS, BasicFS);
+    lengthProgram = buildProgram("geometricFuncs.length", BasicVS, LengthFS);
+    distanceProgram = buildProgram("geometricFuncs.distance", BasicVS, DistanceFS);
+    normalizeProgram = buildProgram("geometricFuncs.normalize", BasicVS, NormalizeFS);
+    faceforwardProgram = buildProgram("geometricFuncs.faceforward", BasicVS, FaceforwardFS);
+    reflectProgram = buildProgram("geometricFuncs.reflect", BasicVS, ReflectFS);
+    refractProgram = buildProgram("geometricFuncs.refract", BasicVS, RefractFS);
 
     // Rectangle vertices
     float rectangleVertices[] = {
@@ -296,78 +214,75 @@ void init() {
 
     // Create buffers
     glGenBuffers(1, &rectangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    stateVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(0);
 
     // Get uniform locations
-    lenVecLoc = glGetUniformLocation(lengthProgram, "uVec");
-    distVec1Loc = glGetUniformLocation(distanceProgram, "uVec1");
-    distVec2Loc = glGetUniformLocation(distanceProgram, "uVec2");
-    normalizeVecLoc = glGetUniformLocation(normalizeProgram, "uVec");
+    lenVecLoc = programUniform(lengthProgram, "uVec");
+    distVec1Loc = programUniform(distanceProgram, "uVec1");
+    distVec2Loc = programUniform(distanceProgram, "uVec2");
+    normalizeVecLoc = programUniform(normalizeProgram, "uVec");
 
     // Faceforward uniform locations
-    faceforwardNLoc = glGetUniformLocation(faceforwardProgram, "uN");
-    faceforwardILoc = glGetUniformLocation(faceforwardProgram, "uI");
-    faceforwardNrefLoc = glGetUniformLocation(faceforwardProgram, "uNref");
+    faceforwardNLoc = programUniform(faceforwardProgram, "uN");
+    faceforwardILoc = programUniform(faceforwardProgram, "uI");
+    faceforwardNrefLoc = programUniform(faceforwardProgram, "uNref");
 
     // Reflect uniform locations
-    reflectILoc = glGetUniformLocation(reflectProgram, "uI");
-    reflectNLoc = glGetUniformLocation(reflectProgram, "uN");
+    reflectILoc = programUniform(reflectProgram, "uI");
+    reflectNLoc = programUniform(reflectProgram, "uN");
 
     // Refract uniform locations
-    refractILoc = glGetUniformLocation(refractProgram, "uI");
-    refractNLoc = glGetUniformLocation(refractProgram, "uN");
-    refractEtaLoc = glGetUniformLocation(refractProgram, "uEta");
+    refractILoc = programUniform(refractProgram, "uI");
+    refractNLoc = programUniform(refractProgram, "uN");
+    refractEtaLoc = programUniform(refractProgram, "uEta");
 }
 
-void draw() {
+static void draw() {
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     // Length test
-    glViewport(0,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,0]
-    glUseProgram(lengthProgram);
+    cellViewport("length", 0,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,0]
+    stateUseProgram(lengthProgram);
     glUniform3fv(lenVecLoc, 1, vec_Len);
     glDrawArrays(GL_TRIANGLES,0,6);
 
     // Distance test
-    glViewport((g_width/3)+5,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,1]
-    glUseProgram(distanceProgram);
+    cellViewport("distance", (g_width/3)+5,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,1]
+    stateUseProgram(distanceProgram);
     glUniform2fv(distVec1Loc, 1, vec1_Distance);
     glUniform2fv(distVec2Loc, 1, vec2_Distance);
     glDrawArrays(GL_TRIANGLES,0,6);
 
     // Normalize test
-    glViewport((2*g_width/3)+10,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,2]
-    glUseProgram(normalizeProgram);
+    cellViewport("normalize", (2*g_width/3)+10,(g_height/2)+5 , (g_width/3)-10, (g_height/2)-5); // [0,2]
+    stateUseProgram(normalizeProgram);
     glUniform3fv(normalizeVecLoc, 1, vec_Normalize);
     glDrawArrays(GL_TRIANGLES,0,6);
 
     // Faceforward test
-    glViewport(0,0 , (g_width/3)-10, (g_height/2)-5); // [1,0]
-    glUseProgram(faceforwardProgram);
+    cellViewport("faceforward", 0,0 , (g_width/3)-10, (g_height/2)-5); // [1,0]
+    stateUseProgram(faceforwardProgram);
     glUniform3fv(faceforwardNLoc, 1, vec_N);
     glUniform3fv(faceforwardILoc, 1, vec_I);
     glUniform3fv(faceforwardNrefLoc, 1, vec_Nref);
     glDrawArrays(GL_TRIANGLES,0,6);
 
     // Reflect test
-    glViewport((g_width/3)+5,0 , (g_width/3)-10, (g_height/2)-5); // [1,1]
-    glUseProgram(reflectProgram);
+    cellViewport("reflect", (g_width/3)+5,0 , (g_width/3)-10, (g_height/2)-5); // [1,1]
+    stateUseProgram(reflectProgram);
     glUniform3fv(reflectILoc, 1, reflect_I);
     glUniform3fv(reflectNLoc, 1, reflect_N);
     glDrawArrays(GL_TRIANGLES,0,6);
 
     // Refract test
-    glViewport((2*g_width/3)+10,0 , (g_width/3)-10, (g_height/2)-5); // [1,2]
-    glUseProgram(refractProgram);
+    cellViewport("refract", (2*g_width/3)+10,0 , (g_width/3)-10, (g_height/2)-5); // [1,2]
+    stateUseProgram(refractProgram);
     glUniform3fv(refractILoc, 1, refract_I);
     glUniform3fv(refractNLoc, 1, refract_N);
     glUniform1f(refractEtaLoc, refract_eta);
     glDrawArrays(GL_TRIANGLES,0,6);
-
-    glfwSwapBuffers(window);
-    glfwPollEvents();
 }
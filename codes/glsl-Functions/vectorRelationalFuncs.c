@@ -1,77 +1,151 @@
-#include <GLFW/glfw3.h>
+#include "../common/glState.h"
+#include "../common/glslGen.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
+#include "../common/verdict.h"
 #include <GLES2/gl2.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-void init();
-void draw();
+static void init();
+static void cleanup();
+static void draw();
+
+enum Relation { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL };
+enum Reduce { REDUCE_NONE, REDUCE_ANY, REDUCE_ALL, REDUCE_NOT };
+
+static const char *relationNames[] = {
+    "lessThan", "lessThanEqual", "greaterThan", "greaterThanEqual", "equal", "notEqual"
+};
+
+// One generated cell: reduce(relation(vec1, vec2)). The expected result is
+// computed here and baked into the shader, which paints green on a match.
+struct RelationCase {
+    const char *name;
+    enum Relation relation;
+    enum Reduce reduce;
+    float vec1[3], vec2[3];
+};
+
+static const struct RelationCase cases[] = {
+    {"lessThan",         LESS,          REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"lessThanEqual",    LESS_EQUAL,    REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"greaterThan",      GREATER,       REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"greaterThanEqual", GREATER_EQUAL, REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"equal",            EQUAL,         REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}},
+    {"notEqual",         NOT_EQUAL,     REDUCE_NONE, {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"any",              GREATER,       REDUCE_ANY,  {1.0f, 2.0f, 3.0f}, {2.0f, 2.0f, 1.0f}},
+    {"all",              EQUAL,         REDUCE_ALL,  {1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}},
+    {"not",              EQUAL,         REDUCE_NOT,  {1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}},
+};
+
+#define CASE_COUNT (int)(sizeof(cases) / sizeof(cases[0]))
+// The relational cases plus the degrees cell
+#define CELL_COUNT (CASE_COUNT + 1)
+#define GRID_COLS 5
 
 // Static global variables
-static GLFWwindow *window;
-static GLuint basicProgram, lessThanProgram, lessThanEqualProgram, greaterThanProgram;
-static GLuint greaterThanEqualProgram, equalProgram, notEqualProgram, anyProgram;
-static GLuint allProgram, notProgram, degreesProgram;
-static unsigned int rectangleVBO;
-
-// Uniform locations
-static GLint lessThanVec1Loc, lessThanVec2Loc;
-static GLint lessThanEqualVec1Loc, lessThanEqualVec2Loc;
-static GLint greaterThanVec1Loc, greaterThanVec2Loc;
-static GLint greaterThanEqualVec1Loc, greaterThanEqualVec2Loc;
-static GLint equalVec1Loc, equalVec2Loc;
-static GLint notEqualVec1Loc, notEqualVec2Loc;
-static GLint anyVecLoc, allVecLoc, notVecLoc;
+static GLuint programs[CASE_COUNT], degreesProgram;
+static char *fragmentShaders[CASE_COUNT];
+static GLint vec1Locs[CASE_COUNT], vec2Locs[CASE_COUNT];
 static GLint degreesRadLoc;
+static unsigned int rectangleVBO;
 
-// Test vectors for comparisons
-static float vec1_Compare[3] = {1.0f, 2.0f, 3.0f};
-static float vec2_Compare[3] = {2.0f, 2.0f, 1.0f};
-static float vec1_Equal[3] = {1.0f, 2.0f, 3.0f};
-static float vec2_Equal[3] = {1.0f, 2.0f, 3.0f};
 static float radians_Test = 3.14159f / 2.0f; // 90 degrees in radians
 
 static int g_width = 1280, g_height = 720;
 
-int main() {
-    glfwInit();
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "GLSL Vector Relational Functions", NULL, NULL);
-    if (window == NULL) {
-        printf("Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(-1);
+static int compare(enum Relation relation, float a, float b) {
+    switch (relation) {
+    case LESS: return a < b;
+    case LESS_EQUAL: return a <= b;
+    case GREATER: return a > b;
+    case GREATER_EQUAL: return a >= b;
+    case EQUAL: return a == b;
+    default: return a != b;
     }
-    glfwMakeContextCurrent(window);
+}
 
-    init();
+static char *generateShader(const struct RelationCase *test) {
+    int bits[3];
+    for (int i = 0; i < 3; i++) {
+        bits[i] = compare(test->relation, test->vec1[i], test->vec2[i]);
+    }
 
-    while (!glfwWindowShouldClose(window)) {
-        draw();
+    const char *relation = relationNames[test->relation];
+    char result[128], expected[64];
+
+    switch (test->reduce) {
+    case REDUCE_ANY:
+    case REDUCE_ALL: {
+        int any = bits[0] || bits[1] || bits[2], all = bits[0] && bits[1] && bits[2];
+        snprintf(result, sizeof(result), "bool result = %s(%s(uVec1, uVec2));",
+                 test->reduce == REDUCE_ANY ? "any" : "all", relation);
+        snprintf(expected, sizeof(expected), "bool expected = %s;",
+                 (test->reduce == REDUCE_ANY ? any : all) ? "true" : "false");
+        break;
+    }
+    case REDUCE_NOT:
+        for (int i = 0; i < 3; i++) bits[i] = !bits[i];
+        // fall through
+    default:
+        snprintf(result, sizeof(result), "bvec3 result = %s%s(uVec1, uVec2)%s;",
+                 test->reduce == REDUCE_NOT ? "not(" : "", relation, test->reduce == REDUCE_NOT ? ")" : "");
+        snprintf(expected, sizeof(expected), "bvec3 expected = bvec3(%s, %s, %s);",
+                 bits[0] ? "true" : "false", bits[1] ? "true" : "false", bits[2] ? "true" : "false");
+        break;
     }
 
+    return formatSource(
+        "#version 100\n"
+        "precision mediump float;\n"
+        "uniform vec3 uVec1;\n"
+        "uniform vec3 uVec2;\n"
+        "void main() {\n"
+        "    %s\n"
+        "    %s\n"
+        "    vec4 color;\n"
+        "    if(result == expected){\n"
+        "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
+        "    } else{\n"
+        "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
+        "    }\n"
+        "    gl_FragColor = color;\n"
+        "}",
+        result, expected);
+}
+
+// Cells fill the grid row by row from the top, left to right across
+// GRID_COLS columns, 5 px apart
+static void cellRect(int index, int *x, int *y, int *w, int *h) {
+    int rows = (CELL_COUNT + GRID_COLS - 1) / GRID_COLS;
+    int col = index % GRID_COLS, row = index / GRID_COLS;
+
+    *x = col * g_width / GRID_COLS + 2 * col;
+    *w = g_width / GRID_COLS - 8;
+    *h = g_height / rows - 5;
+    *y = (rows - 1 - row) * (g_height / rows) + (row < rows - 1 ? 5 : 0);
+}
+
+static void cleanup() {
     glDeleteBuffers(1, &rectangleVBO);
-    glDeleteProgram(basicProgram);
-    glDeleteProgram(lessThanProgram);
-    glDeleteProgram(lessThanEqualProgram);
-    glDeleteProgram(greaterThanProgram);
-    glDeleteProgram(greaterThanEqualProgram);
-    glDeleteProgram(equalProgram);
-    glDeleteProgram(notEqualProgram);
-    glDeleteProgram(anyProgram);
-    glDeleteProgram(allProgram);
-    glDeleteProgram(notProgram);
+    for (int i = 0; i < CASE_COUNT; i++) {
+        glDeleteProgram(programs[i]);
+    }
     glDeleteProgram(degreesProgram);
+}
+
+const struct Suite vectorRelationalFuncsSuite = {
+    "vectorRelationalFuncs", "GLSL Vector Relational Functions", "glsl-Functions/vectorRelationalFuncs.png", &g_width, &g_height, 4, init, draw, cleanup
+};
 
-    glfwTerminate();
-    printf("Program terminated.\n");
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&vectorRelationalFuncsSuite, argc, argv);
 }
+#endif
 
-void init() {
+static void init() {
 
     // Embedded shader strings
     const char *BasicVS = "#version 100\n"
@@ -80,157 +154,6 @@ void init() {
                           "    gl_Position = vec4(aPos, 1.0);\n"
                           "}";
 
-    const char *BasicFS = "#version 100\n"
-                          "precision mediump float;\n"
-                          "void main() {\n"
-                          "    gl_FragColor = vec4(1.0, 1.0, 1.0, 1.0);\n"
-                          "}";
-
-    const char *LessThanFS = "#version 100\n"
-                             "precision mediump float;\n"
-                             "uniform vec3 uVec1;\n"
-                             "uniform vec3 uVec2;\n"
-                             "void main() {\n"
-                             "    bvec3 result = lessThan(uVec1, uVec2);\n"
-                             "    bvec3 expected = bvec3(true, false, false);\n"
-                             "    vec4 color;\n"
-                             "    if(result == expected){\n"
-                             "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                             "    } else{\n"
-                             "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                             "    }\n"
-                             "    gl_FragColor = color;\n"
-                             "}";
-
-    const char *LessThanEqualFS = "#version 100\n"
-                                  "precision mediump float;\n"
-                                  "uniform vec3 uVec1;\n"
-                                  "uniform vec3 uVec2;\n"
-                                  "void main() {\n"
-                                  "    bvec3 result = lessThanEqual(uVec1, uVec2);\n"
-                                  "    bvec3 expected = bvec3(true, true, false);\n"
-                                  "    vec4 color;\n"
-                                  "    if(result == expected){\n"
-                                  "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                                  "    } else{\n"
-                                  "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                                  "    }\n"
-                                  "    gl_FragColor = color;\n"
-                                  "}";
-
-    const char *GreaterThanFS = "#version 100\n"
-                                "precision mediump float;\n"
-                                "uniform vec3 uVec1;\n"
-                                "uniform vec3 uVec2;\n"
-                                "void main() {\n"
-                                "    bvec3 result = greaterThan(uVec1, uVec2);\n"
-                                "    bvec3 expected = bvec3(false, false, true);\n"
-                                "    vec4 color;\n"
-                                "    if(result == expected){\n"
-                                "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                                "    } else{\n"
-                                "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                                "    }\n"
-                                "    gl_FragColor = color;\n"
-                                "}";
-
-    const char *GreaterThanEqualFS = "#version 100\n"
-                                     "precision mediump float;\n"
-                                     "uniform vec3 uVec1;\n"
-                                     "uniform vec3 uVec2;\n"
-                                     "void main() {\n"
-                                     "    bvec3 result = greaterThanEqual(uVec1, uVec2);\n"
-                                     "    bvec3 expected = bvec3(false, true, true);\n"
-                                     "    vec4 color;\n"
-                                     "    if(result == expected){\n"
-                                     "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                                     "    } else{\n"
-                                     "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                                     "    }\n"
-                                     "    gl_FragColor = color;\n"
-                                     "}";
-
-    const char *EqualFS = "#version 100\n"
-                          "precision mediump float;\n"
-                          "uniform vec3 uVec1;\n"
-                          "uniform vec3 uVec2;\n"
-                          "void main() {\n"
-                          "    bvec3 result = equal(uVec1, uVec2);\n"
-                          "    bvec3 expected = bvec3(true, true, true);\n"
-                          "    vec4 color;\n"
-                          "    if(result == expected){\n"
-                          "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                          "    } else{\n"
-                          "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                          "    }\n"
-                          "    gl_FragColor = color;\n"
-                          "}";
-
-    const char *NotEqualFS = "#version 100\n"
-                             "precision mediump float;\n"
-                             "uniform vec3 uVec1;\n"
-                             "uniform vec3 uVec2;\n"
-                             "void main() {\n"
-                             "    bvec3 result = notEqual(uVec1, uVec2);\n"
-                             "    bvec3 expected = bvec3(true, false, true);\n"
-                             "    vec4 color;\n"
-                             "    if(result == expected){\n"
-                             "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                             "    } else{\n"
-                             "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                             "    }\n"
-                             "    gl_FragColor = color;\n"
-                             "}";
-
-    const char *AnyFS = "#version 100\n"
-                        "precision mediump float;\n"
-                        "uniform vec3 uVec1;\n"
-                        "uniform vec3 uVec2;\n"
-                        "void main() {\n"
-                        "    bvec3 comparison = greaterThan(uVec1, uVec2);\n"
-                        "    bool result = any(comparison);\n"
-                        "    vec4 color;\n"
-                        "    if(result == true){\n"
-                        "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                        "    } else{\n"
-                        "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                        "    }\n"
-                        "    gl_FragColor = color;\n"
-                        "}";
-
-    const char *AllFS = "#version 100\n"
-                        "precision mediump float;\n"
-                        "uniform vec3 uVec1;\n"
-                        "uniform vec3 uVec2;\n"
-                        "void main() {\n"
-                        "    bvec3 comparison = equal(uVec1, uVec2);\n"
-                        "    bool result = all(comparison);\n"
-                        "    vec4 color;\n"
-                        "    if(result == true){\n"
-                        "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                        "    } else{\n"
-                        "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                        "    }\n"
-                        "    gl_FragColor = color;\n"
-                        "}";
-
-    const char *NotFS = "#version 100\n"
-                        "precision mediump float;\n"
-                        "uniform vec3 uVec1;\n"
-                        "uniform vec3 uVec2;\n"
-                        "void main() {\n"
-                        "    bvec3 comparison = equal(uVec1, uVec2);\n"
-                        "    bvec3 result = not(comparison);\n"
-                        "    bvec3 expected = bvec3(false, false, false);\n"
-                        "    vec4 color;\n"
-                        "    if(result == expected){\n"
-                        "        color = vec4(0.0, 1.0, 0.0, 1.0);\n"
-                        "    } else{\n"
-                        "        color = vec4(1.0, 0.0, 0.0, 1.0);\n"
-                        "    }\n"
-                        "    gl_FragColor = color;\n"
-                        "}";
-
     const char *DegreesFS = "#version 100\n"
                             "precision mediump float;\n"
                             "uniform float uRadians;\n"
@@ -245,125 +168,20 @@ void init() {
                             "    gl_FragColor = color;\n"
                             "}";
 
-    // Create vertex shader (shared by all programs)
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &BasicVS, NULL);
-    glCompileShader(vertexShader);
-
-    // Create fragment shaders
-    GLuint basicFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(basicFShader, 1, &BasicFS, NULL);
-    glCompileShader(basicFShader);
-
-    GLuint lessThanFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(lessThanFShader, 1, &LessThanFS, NULL);
-    glCompileShader(lessThanFShader);
-
-    GLuint lessThanEqualFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(lessThanEqualFShader, 1, &LessThanEqualFS, NULL);
-    glCompileShader(lessThanEqualFShader);
-
-    GLuint greaterThanFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(greaterThanFShader, 1, &GreaterThanFS, NULL);
-    glCompileShader(greaterThanFShader);
-
-    GLuint greaterThanEqualFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(greaterThanEqualFShader, 1, &GreaterThanEqualFS, NULL);
-    glCompileShader(greaterThanEqualFShader);
-
-    GLuint equalFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(equalFShader, 1, &EqualFS, NULL);
-    glCompileShader(equalFShader);
-
-    GLuint notEqualFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(notEqualFShader, 1, &NotEqualFS, NULL);
-    glCompileShader(notEqualFShader);
-
-    GLuint anyFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(anyFShader, 1, &AnyFS, NULL);
-    glCompileShader(anyFShader);
-
-    GLuint allFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(allFShader, 1, &AllFS, NULL);
-    glCompileShader(allFShader);
-
-    GLuint notFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(notFShader, 1, &NotFS, NULL);
-    glCompileShader(notFShader);
-
-    GLuint degreesFShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(degreesFShader, 1, &DegreesFS, NULL);
-    glCompileShader(degreesFShader);
-
-    // Create shader programs
-    basicProgram = glCreateProgram();
-    glAttachShader(basicProgram, vertexShader);
-    glAttachShader(basicProgram, basicFShader);
-    glLinkProgram(basicProgram);
-
-    lessThanProgram = glCreateProgram();
-    glAttachShader(lessThanProgram, vertexShader);
-    glAttachShader(lessThanProgram, lessThanFShader);
-    glLinkProgram(lessThanProgram);
-
-    lessThanEqualProgram = glCreateProgram();
-    glAttachShader(lessThanEqualProgram, vertexShader);
-    glAttachShader(lessThanEqualProgram, lessThanEqualFShader);
-    glLinkProgram(lessThanEqualProgram);
-
-    greaterThanProgram = glCreateProgram();
-    glAttachShader(greaterThanProgram, vertexShader);
-    glAttachShader(greaterThanProgram, greaterThanFShader);
-    glLinkProgram(greaterThanProgram);
-
-    greaterThanEqualProgram = glCreateProgram();
-    glAttachShader(greaterThanEqualProgram, vertexShader);
-    glAttachShader(greaterThanEqualProgram, greaterThanEqualFShader);
-    glLinkProgram(greaterThanEqualProgram);
-
-    equalProgram = glCreateProgram();
-    glAttachShader(equalProgram, vertexShader);
-    glAttachShader(equalProgram, equalFShader);
-    glLinkProgram(equalProgram);
-
-    notEqualProgram = glCreateProgram();
-    glAttachShader(notEqualProgram, vertexShader);
-    glAttachShader(notEqualProgram, notEqualFShader);
-    glLinkProgram(notEqualProgram);
-
-    anyProgram = glCreateProgram();
-    glAttachShader(anyProgram, vertexShader);
-    glAttachShader(anyProgram, anyFShader);
-    glLinkProgram(anyProgram);
-
-    allProgram = glCreateProgram();
-    glAttachShader(allProgram, vertexShader);
-    glAttachShader(allProgram, allFShader);
-    glLinkProgram(allProgram);
-
-    notProgram = glCreateProgram();
-    glAttachShader(notProgram, vertexShader);
-    glAttachShader(notProgram, notFShader);
-    glLinkProgram(notProgram);
-
-    degreesProgram = glCreateProgram();
-    glAttachShader(degreesProgram, vertexShader);
-    glAttachShader(degreesProgram, degreesFShader);
-    glLinkProgram(degreesProgram);
-
-    // Clean up shaders
-    glDeleteShader(vertexShader);
-    glDeleteShader(basicFShader);
-    glDeleteShader(lessThanFShader);
-    glDeleteShader(lessThanEqualFShader);
-    glDeleteShader(greaterThanFShader);
-    glDeleteShader(greaterThanEqualFShader);
-    glDeleteShader(equalFShader);
-    glDeleteShader(notEqualFShader);
-    glDeleteShader(anyFShader);
-    glDeleteShader(allFShader);
-    glDeleteShader(notFShader);
-    glDeleteShader(degreesFShader);
+    // Create shader programs; generated sources live as long as the process
+    for (int i = 0; i < CASE_COUNT; i++) {
+        if (!fragmentShaders[i]) {
+            fragmentShaders[i] = generateShader(&cases[i]);
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "vectorRelationalFuncs.%s", cases[i].name);
+        programs[i] = buildProgram(name, BasicVS, fragmentShaders[i]);
+        vec1Locs[i] = programUniform(programs[i], "uVec1");
+        vec2Locs[i] = programUniform(programs[i], "uVec2");
+    }
+    degreesProgram = buildProgram("vectorRelationalFuncs.degrees", BasicVS, DegreesFS);
+    degreesRadLoc = programUniform(degreesProgram, "uRadians");
 
     // Rectangle vertices
     float rectangleVertices[] = {
@@ -378,106 +196,33 @@ void init() {
     // Create buffers
     glGenBuffers(1, &rectangleVBO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // Get uniform locations
-    lessThanVec1Loc = glGetUniformLocation(lessThanProgram, "uVec1");
-    lessThanVec2Loc = glGetUniformLocation(lessThanProgram, "uVec2");
-    lessThanEqualVec1Loc = glGetUniformLocation(lessThanEqualProgram, "uVec1");
-    lessThanEqualVec2Loc = glGetUniformLocation(lessThanEqualProgram, "uVec2");
-    greaterThanVec1Loc = glGetUniformLocation(greaterThanProgram, "uVec1");
-    greaterThanVec2Loc = glGetUniformLocation(greaterThanProgram, "uVec2");
-    greaterThanEqualVec1Loc = glGetUniformLocation(greaterThanEqualProgram, "uVec1");
-    greaterThanEqualVec2Loc = glGetUniformLocation(greaterThanEqualProgram, "uVec2");
-    equalVec1Loc = glGetUniformLocation(equalProgram, "uVec1");
-    equalVec2Loc = glGetUniformLocation(equalProgram, "uVec2");
-    notEqualVec1Loc = glGetUniformLocation(notEqualProgram, "uVec1");
-    notEqualVec2Loc = glGetUniformLocation(notEqualProgram, "uVec2");
-    anyVecLoc = glGetUniformLocation(anyProgram, "uVec1");
-    allVecLoc = glGetUniformLocation(allProgram, "uVec1");
-    notVecLoc = glGetUniformLocation(notProgram, "uVec1");
-    degreesRadLoc = glGetUniformLocation(degreesProgram, "uRadians");
+    stateVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(0);
 }
 
-void draw() {
+static void draw() {
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
-
-    // lessThan test - (1,2,3) < (2,2,1) = (true, false, false)
-    glViewport(0, (g_height/2)+5, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(lessThanProgram);
-    glUniform3fv(lessThanVec1Loc, 1, vec1_Compare);
-    glUniform3fv(lessThanVec2Loc, 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // lessThanEqual test - (1,2,3) <= (2,2,1) = (true, true, false)
-    glViewport((g_width/5)+2, (g_height/2)+5, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(lessThanEqualProgram);
-    glUniform3fv(lessThanEqualVec1Loc, 1, vec1_Compare);
-    glUniform3fv(lessThanEqualVec2Loc, 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // greaterThan test - (1,2,3) > (2,2,1) = (false, false, true)
-    glViewport((2*g_width/5)+4, (g_height/2)+5, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(greaterThanProgram);
-    glUniform3fv(greaterThanVec1Loc, 1, vec1_Compare);
-    glUniform3fv(greaterThanVec2Loc, 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // greaterThanEqual test - (1,2,3) >= (2,2,1) = (false, true, true)
-    glViewport((3*g_width/5)+6, (g_height/2)+5, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(greaterThanEqualProgram);
-    glUniform3fv(greaterThanEqualVec1Loc, 1, vec1_Compare);
-    glUniform3fv(greaterThanEqualVec2Loc, 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // equal test - equal vectors should return all true
-    glViewport((4*g_width/5)+8, (g_height/2)+5, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(equalProgram);
-    glUniform3fv(equalVec1Loc, 1, vec1_Equal);
-    glUniform3fv(equalVec2Loc, 1, vec2_Equal);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // notEqual test - (1,2,3) != (2,2,1) = (true, false, true)
-    glViewport(0, 0, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(notEqualProgram);
-    glUniform3fv(notEqualVec1Loc, 1, vec1_Compare);
-    glUniform3fv(notEqualVec2Loc, 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // any test - any component of (1,2,3) > (2,2,1) is true
-    glViewport((g_width/5)+2, 0, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(anyProgram);
-    glUniform3fv(anyVecLoc, 1, vec1_Compare);
-    glUniform3fv(glGetUniformLocation(anyProgram, "uVec2"), 1, vec2_Compare);
-    glDrawArrays(GL_TRIANGLES,0,6);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
 
-    // all test - all components of equal vectors are equal
-    glViewport((2*g_width/5)+4, 0, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(allProgram);
-    glUniform3fv(allVecLoc, 1, vec1_Equal);
-    glUniform3fv(glGetUniformLocation(allProgram, "uVec2"), 1, vec2_Equal);
-    glDrawArrays(GL_TRIANGLES,0,6);
-
-    // not test - logical complement of equal comparison
-    glViewport((3*g_width/5)+6, 0, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(notProgram);
-    glUniform3fv(notVecLoc, 1, vec1_Equal);
-    glUniform3fv(glGetUniformLocation(notProgram, "uVec2"), 1, vec2_Equal);
-    glDrawArrays(GL_TRIANGLES,0,6);
+    int x, y, w, h;
+    for (int i = 0; i < CASE_COUNT; i++) {
+        cellRect(i, &x, &y, &w, &h);
+        cellViewport(cases[i].name, x, y, w, h);
+        stateUseProgram(programs[i]);
+        glUniform3fv(vec1Locs[i], 1, cases[i].vec1);
+        glUniform3fv(vec2Locs[i], 1, cases[i].vec2);
+        glDrawArrays(GL_TRIANGLES,0,6);
+    }
 
     // degrees test - convert PI/2 radians to 90 degrees
-    glViewport((4*g_width/5)+8, 0, (g_width/5)-8, (g_height/2)-5);
-    glUseProgram(degreesProgram);
+    cellRect(CASE_COUNT, &x, &y, &w, &h);
+    cellViewport("degrees", x, y, w, h);
+    stateUseProgram(degreesProgram);
     glUniform1f(degreesRadLoc, radians_Test);
     glDrawArrays(GL_TRIANGLES,0,6);
-
-    glfwSwapBuffers(window);
-    glfwPollEvents();
 }
@@ -1,119 +1,103 @@
 #include <GLES2/gl2.h>
-#include <GLFW/glfw3.h>
+#include "../common/glState.h"
+#include "../common/pipe.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
 #include <stdlib.h>
 #include <stdio.h>
 
-void init();
-void drawHelper(unsigned int VBO, int size, float color[3]);
-void depthTestFunc_test(GLenum type);
-void draw();
+static void init();
+static void cleanup();
+static void drawHelper(unsigned int VBO, int size, float color[3]);
+static void depthTestFunc_test(GLenum type);
+static void draw();
 
-int g_width = 1280, g_height = 720;
+static int g_width = 1280, g_height = 720;
 
 static float navy[3] = {0.0f, 0.125f, 0.376f};
 static float yellow[3] = {1.0f, 0.835f, 0.0f};
 
-static GLFWwindow *window;
 static GLuint shaderProgram;
 static unsigned int triangleVBO, rectangleVBO;
 
-int main() {
-
-    // GLFW initialization
-    glfwInit();
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "Depth Test Example", NULL, NULL);
-    if (!window) {
-        fprintf(stderr, "Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(EXIT_FAILURE);
-    }
-
-    glfwMakeContextCurrent(window);
-
-    init();
-
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // Cleanup
+static void cleanup() {
     glDeleteBuffers(1, &triangleVBO);
     glDeleteBuffers(1, &rectangleVBO);
     glDeleteProgram(shaderProgram);
+}
+
+const struct Suite depthFuncSuite = {
+    "depthFunc", "Depth Test Example", "openGL-Functions/depthFunc.png", &g_width, &g_height, 0, init, draw, cleanup
+};
 
-    glfwTerminate();
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&depthFuncSuite, argc, argv);
 }
+#endif
 
-void drawHelper(unsigned int VBO, int size, float color[3]) {
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(0);
+static void drawHelper(unsigned int VBO, int size, float color[3]) {
+    stateBindBuffer(GL_ARRAY_BUFFER, VBO);
+    stateVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    stateEnableVertexAttribArray(0);
 
-    GLint uColorLocation = glGetUniformLocation(shaderProgram, "uColor");
-    glUniform3fv(uColorLocation,1, color);
+    GLint uColorLocation = programUniform(shaderProgram, "uColor");
+    pipeUniform3fv(uColorLocation,1, color);
 
-    glDrawArrays(GL_TRIANGLES, 0, size);
+    pipeDrawArrays(GL_TRIANGLES, 0, size);
 }
 
-void draw(){
+static void draw(){
     // Clear the screen
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    pipeClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    pipeClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(shaderProgram);
+    stateUseProgram(shaderProgram);
 
     //------------------------------------No Test-------------------------------------
-    glViewport(0, 0, g_width/7, g_height); // [0,0]
-    glDisable(GL_DEPTH_TEST);
+    pipeViewport(0, 0, g_width/7, g_height); // [0,0]
+    pipeDisable(GL_DEPTH_TEST);
     drawHelper(triangleVBO, 3, navy);
     drawHelper(rectangleVBO, 6, yellow);
 
     //------------------------------------GL_NEVER------------------------------------
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
+    pipeEnable(GL_DEPTH_TEST);
+    pipeDepthMask(GL_TRUE);
 
-    glViewport(g_width/7, 0, g_width/7, g_height); // [0,1]
+    pipeViewport(g_width/7, 0, g_width/7, g_height); // [0,1]
     depthTestFunc_test(GL_LESS);
 
     //------------------------------------GL_EQUAL------------------------------------
-    glViewport((g_width/7)*2, 0, g_width/7, g_height); // [0,2]
+    pipeViewport((g_width/7)*2, 0, g_width/7, g_height); // [0,2]
     depthTestFunc_test( GL_EQUAL);
 
     //------------------------------------GL_LEQUAL------------------------------------
-    glViewport((g_width/7)*3, 0, g_width/7, g_height); // [0,3]
+    pipeViewport((g_width/7)*3, 0, g_width/7, g_height); // [0,3]
     depthTestFunc_test( GL_LEQUAL);
 
     //------------------------------------GL_NOTEQUAL------------------------------------
-    glViewport((g_width/7)*4, 0, g_width/7, g_height); // [0,4]
+    pipeViewport((g_width/7)*4, 0, g_width/7, g_height); // [0,4]
     depthTestFunc_test( GL_NOTEQUAL);
 
     //------------------------------------GL_GEQUAL------------------------------------
-    glViewport((g_width/7)*5, 0, g_width/7, g_height); // [0,5]
+    pipeViewport((g_width/7)*5, 0, g_width/7, g_height); // [0,5]
     depthTestFunc_test( GL_GEQUAL);
 
     //------------------------------------GL_ALWAYS------------------------------------
-    glViewport((g_width/7)*6, 0, g_width/7, g_height); // [0,6]
+    pipeViewport((g_width/7)*6, 0, g_width/7, g_height); // [0,6]
     depthTestFunc_test( GL_ALWAYS);
 
-    glDisable(GL_DEPTH_TEST);
+    pipeDisable(GL_DEPTH_TEST);
 }
 
-void depthTestFunc_test(GLenum type) {
-    glDepthFunc(type);
+static void depthTestFunc_test(GLenum type) {
+    pipeDepthFunc(type);
 
     drawHelper(triangleVBO, 3, navy);
     drawHelper(rectangleVBO, 6, yellow);
 }
 
-void init() {
+static void init() {
 
     // Shader source code
     const char *VSsource = "#version 100\n"
@@ -131,24 +115,8 @@ void init() {
                                   "    gl_FragColor = vec4(uColor, 1.0);\n"
                                   "}\n";
 
-
-
     // Shader compilation and program creation
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &VSsource, NULL);
-    glCompileShader(vertexShader);
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &FSsource, NULL);
-    glCompileShader(fragmentShader);
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    shaderProgram = buildProgram("depthFunc", VSsource, FSsource);
 
     // Triangle vertices
     float triangleVertices[] = {
@@ -169,12 +137,12 @@ void init() {
 
     // Generate and bind VBOs
     glGenBuffers(1, &triangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
+    stateBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
+    pipeBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
 
     glGenBuffers(1, &rectangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
+    pipeBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
 
-    glEnable(GL_DEPTH_TEST);
+    pipeEnable(GL_DEPTH_TEST);
 }
\ No newline at end of file
@@ -1,97 +1,78 @@
 #include <GLES2/gl2.h>
-#include <GLFW/glfw3.h>
+#include "../common/glState.h"
+#include "../common/pipe.h"
+#include "../common/shader.h"
+#include "../common/suite.h"
 #include <stdlib.h>
 #include <stdio.h>
 
-void init();
-void drawHelper(unsigned int VBO, int size, float color[3]);
-void GL_KEEP_test();
-void GL_ZERO_test();
-void GL_REPLACE_test();
-void GL_INCR_test();
-void GL_DECR_test();
-void GL_INVERT_test();
-void GL_INCR_WRAP_test();
-void GL_DECR_WRAP_test();
-void draw();
-
-int g_width = 1280, g_height = 720;
+static void init();
+static void cleanup();
+static void drawHelper(unsigned int VBO, int size, float color[3]);
+static void GL_KEEP_test();
+static void GL_ZERO_test();
+static void GL_REPLACE_test();
+static void GL_INCR_test();
+static void GL_DECR_test();
+static void GL_INVERT_test();
+static void GL_INCR_WRAP_test();
+static void GL_DECR_WRAP_test();
+static void draw();
+
+static int g_width = 1280, g_height = 720;
 
 static float navy[3] = {0.0f, 0.125f, 0.376f};
 static float yellow[3] = {1.0f, 0.835f, 0.0f};
 static float green[3] = {0.0f, 0.65f, 0.2f};
 
-static GLFWwindow *window;
 static GLuint shaderProgram;
 static unsigned int triangleVBO, rectangleVBO, littleTriangleVBO;
 
-
-int main() {
-
-    // GLFW initialization
-    glfwInit();
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-
-    window = glfwCreateWindow(g_width, g_height, "Depth Test Example", NULL, NULL);
-    if (!window) {
-        fprintf(stderr, "Failed to create GLFW window\n");
-        glfwTerminate();
-        exit(EXIT_FAILURE);
-    }
-
-    glfwMakeContextCurrent(window);
-
-    init();
-
-    while (!glfwWindowShouldClose(window)) {
-        draw();
-
-        // Swap buffers and poll events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
-
-    // Cleanup
+static void cleanup() {
     glDeleteBuffers(1, &triangleVBO);
     glDeleteBuffers(1, &rectangleVBO);
     glDeleteBuffers(1, &littleTriangleVBO);
     glDeleteProgram(shaderProgram);
+}
+
+const struct Suite stencilOpSeparateSuite = {
+    "stencilOpSeparate", "Depth Test Example", "openGL-Functions/stencilOpSeparate.png", &g_width, &g_height, 0, init, draw, cleanup
+};
 
-    glfwTerminate();
-    printf("Program terminated.\n");
-    return 0;
+#ifndef SUITE_RUNNER
+int main(int argc, char **argv) {
+    return suiteMain(&stencilOpSeparateSuite, argc, argv);
 }
+#endif
 
-void drawHelper(unsigned int VBO, int size, float color[3]) {
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+static void drawHelper(unsigned int VBO, int size, float color[3]) {
+    stateBindBuffer(GL_ARRAY_BUFFER, VBO);
+    stateVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    stateEnableVertexAttribArray(0);
 
-    GLint uColorLocation = glGetUniformLocation(shaderProgram, "uColor");
-    glUniform3fv(uColorLocation, 1, color);
+    GLint uColorLocation = programUniform(shaderProgram, "uColor");
+    pipeUniform3fv(uColorLocation, 1, color);
 
-    glDrawArrays(GL_TRIANGLES, 0, size);
+    pipeDrawArrays(GL_TRIANGLES, 0, size);
 }
 
-void draw() {
+static void draw() {
     // Clear the screen
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-    glClearStencil(5);
-    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    pipeClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    pipeClearStencil(5);
+    pipeClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(shaderProgram);
+    stateUseProgram(shaderProgram);
 
     //-----------------------------No Test-------------------------------
-    glDisable(GL_STENCIL_TEST);
-    glViewport(0, (g_height/3)*2, g_width/3, g_height/3);
+    pipeDisable(GL_STENCIL_TEST);
+    pipeViewport(0, (g_height/3)*2, g_width/3, g_height/3);
 
     drawHelper(triangleVBO, 3, navy);
     drawHelper(rectangleVBO, 6, yellow);
     drawHelper(littleTriangleVBO, 3, green);
 
-    glEnable(GL_STENCIL_TEST);
+    pipeEnable(GL_STENCIL_TEST);
 
     //-----------------------------GL_KEEP-------------------------------
     GL_KEEP_test();
@@ -117,147 +98,147 @@ void draw() {
     //-----------------------------GL_DECR_WRAP-------------------------------
     GL_DECR_WRAP_test();
 
-    glDisable(GL_STENCIL_TEST);
+    pipeDisable(GL_STENCIL_TEST);
 }
 
-void GL_KEEP_test() {
-    glViewport(g_width/3, (g_height/3)*2, g_width/3, g_height/3);
+static void GL_KEEP_test() {
+    pipeViewport(g_width/3, (g_height/3)*2, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_KEEP);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_KEEP, GL_KEEP, GL_KEEP);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 5, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_KEEP);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 5, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_KEEP);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 5, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 5, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_ZERO_test() {
-    glViewport((g_width/3)*2, (g_height/3)*2, g_width/3, g_height/3);
+static void GL_ZERO_test() {
+    pipeViewport((g_width/3)*2, (g_height/3)*2, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_ZERO, GL_ZERO, GL_ZERO);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_ZERO, GL_ZERO, GL_ZERO);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 5, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_ZERO, GL_ZERO, GL_ZERO);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 5, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_ZERO, GL_ZERO, GL_ZERO);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_REPLACE_test() {
-    glViewport(0, g_height/3, g_width/3, g_height/3);
+static void GL_REPLACE_test() {
+    pipeViewport(0, g_height/3, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_REPLACE, GL_REPLACE, GL_REPLACE);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 1, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 1, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_REPLACE, GL_REPLACE, GL_REPLACE);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 1, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 1, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_INCR_test() {
-    glClearStencil(254);
-    glClear(GL_STENCIL_BUFFER_BIT);
+static void GL_INCR_test() {
+    pipeClearStencil(254);
+    pipeClear(GL_STENCIL_BUFFER_BIT);
 
-    glViewport(g_width/3, g_height/3, g_width/3, g_height/3);
+    pipeViewport(g_width/3, g_height/3, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_INCR, GL_INCR, GL_INCR);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_INCR, GL_INCR, GL_INCR);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 255, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_INCR, GL_INCR, GL_INCR);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 255, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_INCR, GL_INCR, GL_INCR);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 
 }
 
-void GL_DECR_test() {
-    glClearStencil(1);
-    glClear(GL_STENCIL_BUFFER_BIT);
+static void GL_DECR_test() {
+    pipeClearStencil(1);
+    pipeClear(GL_STENCIL_BUFFER_BIT);
 
-    glViewport((g_width/3)*2, g_height/3, g_width/3, g_height/3);
+    pipeViewport((g_width/3)*2, g_height/3, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_DECR, GL_DECR, GL_DECR);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_DECR, GL_DECR, GL_DECR);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 0, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_DECR, GL_DECR, GL_DECR);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 0, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_DECR, GL_DECR, GL_DECR);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 255, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 255, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_INVERT_test() {
-    glClearStencil(5);
-    glClear(GL_STENCIL_BUFFER_BIT);
+static void GL_INVERT_test() {
+    pipeClearStencil(5);
+    pipeClear(GL_STENCIL_BUFFER_BIT);
 
-    glViewport(0, 0, g_width/3, g_height/3);
+    pipeViewport(0, 0, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_INVERT, GL_INVERT, GL_INVERT);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_INVERT, GL_INVERT, GL_INVERT);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 250, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_INVERT, GL_INVERT, GL_INVERT);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 250, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_INVERT, GL_INVERT, GL_INVERT);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 5, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 5, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_INCR_WRAP_test() {
-    glClearStencil(254);
-    glClear(GL_STENCIL_BUFFER_BIT);
+static void GL_INCR_WRAP_test() {
+    pipeClearStencil(254);
+    pipeClear(GL_STENCIL_BUFFER_BIT);
 
-    glViewport(g_width/3, 0, g_width/3, g_height/3);
+    pipeViewport(g_width/3, 0, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_INCR_WRAP, GL_INCR_WRAP, GL_INCR_WRAP);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_INCR_WRAP, GL_INCR_WRAP, GL_INCR_WRAP);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 255, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_INCR_WRAP, GL_INCR_WRAP, GL_INCR_WRAP);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 255, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_INCR_WRAP, GL_INCR_WRAP, GL_INCR_WRAP);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 0, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 }
 
-void GL_DECR_WRAP_test() {
-    glClearStencil(1);
-    glClear(GL_STENCIL_BUFFER_BIT);
+static void GL_DECR_WRAP_test() {
+    pipeClearStencil(1);
+    pipeClear(GL_STENCIL_BUFFER_BIT);
 
-    glViewport((g_width/3)*2, 0, g_width/3, g_height/3);
+    pipeViewport((g_width/3)*2, 0, g_width/3, g_height/3);
 
-    glStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
-    glStencilOpSeparate(GL_FRONT, GL_DECR_WRAP, GL_DECR_WRAP, GL_DECR_WRAP);
+    pipeStencilFuncSeparate(GL_FRONT_AND_BACK, GL_ALWAYS, 1, 0xFF);
+    pipeStencilOpSeparate(GL_FRONT, GL_DECR_WRAP, GL_DECR_WRAP, GL_DECR_WRAP);
     drawHelper(triangleVBO, 3, navy);
 
-    glStencilFuncSeparate(GL_FRONT, GL_EQUAL, 0, 0xFF);
-    glStencilOpSeparate(GL_BACK, GL_DECR_WRAP, GL_DECR_WRAP, GL_DECR_WRAP);
+    pipeStencilFuncSeparate(GL_FRONT, GL_EQUAL, 0, 0xFF);
+    pipeStencilOpSeparate(GL_BACK, GL_DECR_WRAP, GL_DECR_WRAP, GL_DECR_WRAP);
     drawHelper(rectangleVBO, 6, yellow);
 
-    glStencilFuncSeparate(GL_BACK, GL_EQUAL, 255, 0xFF);
+    pipeStencilFuncSeparate(GL_BACK, GL_EQUAL, 255, 0xFF);
     drawHelper(littleTriangleVBO, 3, green);
 
 }
 
-void init() {
+static void init() {
     // Shader source codes
     const char *VSsource = "#version 100\n"
                            "attribute vec3 aPos;\n"
@@ -275,21 +256,7 @@ void init() {
                            "}\n";
 
     // Shader compilation and program creation
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &VSsource, NULL);
-    glCompileShader(vertexShader);
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &FSsource, NULL);
-    glCompileShader(fragmentShader);
-
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    shaderProgram = buildProgram("stencilOpSeparate", VSsource, FSsource);
 
     // Vertex data
     float triangleVertices[] = {
@@ -315,14 +282,14 @@ void init() {
 
     // Generate and bind VBOs
     glGenBuffers(1, &triangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
+    stateBindBuffer(GL_ARRAY_BUFFER, triangleVBO);
+    pipeBufferData(GL_ARRAY_BUFFER, sizeof(triangleVertices), triangleVertices, GL_STATIC_DRAW);
 
     glGenBuffers(1, &rectangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
+    stateBindBuffer(GL_ARRAY_BUFFER, rectangleVBO);
+    pipeBufferData(GL_ARRAY_BUFFER, sizeof(rectangleVertices), rectangleVertices, GL_STATIC_DRAW);
 
     glGenBuffers(1, &littleTriangleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, littleTriangleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(littleTriangleVertices), littleTriangleVertices, GL_STATIC_DRAW);
+    stateBindBuffer(GL_ARRAY_BUFFER, littleTriangleVBO);
+    pipeBufferData(GL_ARRAY_BUFFER, sizeof(littleTriangleVertices), littleTriangleVertices, GL_STATIC_DRAW);
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/suite.h"
+
+// Every suite, built with -DSUITE_RUNNER so they drop their own main().
+extern const struct Suite stencilOpSuite;
+extern const struct Suite stencilOpSeparateSuite;
+extern const struct Suite stencilFuncSuite;
+extern const struct Suite stencilFuncSeparateSuite;
+extern const struct Suite stencilMaskSeparateSuite;
+extern const struct Suite depthFuncSuite;
+extern const struct Suite enableSuite;
+extern const struct Suite commonFuncsSuite;
+extern const struct Suite exponentialSuite;
+extern const struct Suite angleTrigonometrySuite;
+extern const struct Suite geometricFuncsSuite;
+extern const struct Suite vectorRelationalFuncsSuite;
+
+static const struct Suite *suites[] = {
+    &stencilOpSuite,
+    &stencilOpSeparateSuite,
+    &stencilFuncSuite,
+    &stencilFuncSeparateSuite,
+    &stencilMaskSeparateSuite,
+    &depthFuncSuite,
+    &enableSuite,
+    &commonFuncsSuite,
+    &exponentialSuite,
+    &angleTrigonometrySuite,
+    &geometricFuncsSuite,
+    &vectorRelationalFuncsSuite,
+};
+
+#define SUITE_COUNT (int)(sizeof(suites) / sizeof(suites[0]))
+
+static const struct Suite *findSuite(const char *name) {
+    for (int i = 0; i < SUITE_COUNT; i++) {
+        if (strcmp(suites[i]->name, name) == 0) {
+            return suites[i];
+        }
+    }
+    return NULL;
+}
+
+// Usage: runner [--headless] [--frames N] [--warmup M] [--golden DIR]
+//               [--shader-bench N] [--accuracy SIDE] [--alu-bench K]
+//               [--uber | --batched-cells] [--uber-bench N]
+//               [--stencil-sweep SIDE [--stencil-sweep-limit N]]
+//               [--depth-check SIDE] [--depth-matrix SIDE]
+//               [--reference | --reference-dump DIR]
+//               [--precision P | --precision-report] [suite...]
+// Runs the named suites (all of them by default) one after another in a single
+// context, so shader compilers and driver state stay warm between suites.
+int main(int argc, char **argv) {
+    argc = suiteParseArgs(argc, argv);
+
+    const struct Suite *selected[SUITE_COUNT];
+    int count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0) {
+            continue;
+        }
+
+        const struct Suite *suite = findSuite(argv[i]);
+        if (!suite) {
+            printf("Unknown suite: %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        if (count < SUITE_COUNT) {
+            selected[count++] = suite;
+        }
+    }
+
+    if (count == 0) {
+        for (int i = 0; i < SUITE_COUNT; i++) {
+            selected[count++] = suites[i];
+        }
+    }
+
+    // The context is created once, with the most samples any suite asks for.
+    int samples = 0;
+    for (int i = 0; i < count; i++) {
+        if (selected[i]->samples > samples) {
+            samples = selected[i]->samples;
+        }
+    }
+
+    if (!platformInit(selected[0]->title, *selected[0]->width, *selected[0]->height, samples)) {
+        printf("Failed to create context\n");
+        return EXIT_FAILURE;
+    }
+
+    int failed = 0;
+    if (suitePrecisionReport()) {
+        if (!runPrecisionReport(selected, count)) {
+            failed++;
+        }
+    } else {
+        for (int i = 0; i < count; i++) {
+            printf("== %s\n", selected[i]->name);
+            if (!runSuite(selected[i])) {
+                failed++;
+            }
+        }
+    }
+
+    if (!suiteShutdown()) {
+        failed++;
+    }
+    return failed ? 1 : 0;
+}